@@ -0,0 +1,99 @@
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Nanoseconds per block allocated on a producer and freed on a consumer, handed over in batches
+template<class Alloc, class Free>
+double crossThread(size_t blocks, size_t size, Alloc alloc, Free release) {
+    const size_t batchSize = 256;
+    std::mutex mutex;
+    std::vector<std::vector<void*>> handoff;
+    bool done = false;
+
+    auto start = Clock::now();
+    std::thread consumer([&] {
+        for (;;) {
+            std::vector<std::vector<void*>> batches;
+            bool finished = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                batches.swap(handoff);
+                finished = done;
+            }
+            for (auto& batch : batches) {
+                for (void* p : batch) {
+                    release(p, size);
+                }
+            }
+            if (finished) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<void*> batch;
+    for (size_t i = 0; i < blocks; ++i) {
+        batch.push_back(alloc(size));
+        if (batch.size() == batchSize) {
+            std::lock_guard<std::mutex> lock(mutex);
+            handoff.push_back(std::move(batch));
+            batch.clear();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handoff.push_back(std::move(batch));
+        done = true;
+    }
+    consumer.join();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / blocks;
+}
+
+// Nanoseconds per task carrying a closure too large for TaskFunction's inline buffer
+double closureTasks(size_t threads, size_t tasks) {
+    ThreadPool pool(threads);
+    std::array<char, 200> payload{};
+    auto start = Clock::now();
+    for (size_t i = 0; i < tasks; ++i) {
+        pool.post([payload] { (void)payload; });
+    }
+    pool.waitForCompletion();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / tasks;
+}
+
+int main(int argc, char** argv) {
+    size_t blocks = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    SlabPool& slab = SlabPool::instance();
+
+    std::cout << "Allocated on one thread, freed on another, nanoseconds per block" << std::endl;
+    std::cout << std::left << std::setw(8) << "bytes" << std::right << std::setw(12) << "malloc"
+              << std::setw(12) << "slab" << std::endl;
+    for (size_t size : {64, 256, 512}) {
+        double heap = crossThread(blocks, size, [](size_t n) { return std::malloc(n); },
+                                  [](void* p, size_t) { std::free(p); });
+        double pooled = crossThread(blocks, size, [&slab](size_t n) { return slab.allocate(n); },
+                                    [&slab](void* p, size_t n) { slab.deallocate(p, n); });
+        std::cout << std::left << std::setw(8) << size << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << heap << std::setw(12) << pooled << std::endl;
+    }
+
+    SlabStats before = slab.stats();
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    double perTask = closureTasks(threads, blocks);
+    SlabStats after = slab.stats();
+    std::cout << "\n200-byte closures on " << threads << " workers: " << std::fixed << std::setprecision(1)
+              << perTask << " ns/task, " << after.hits - before.hits << " slab hits, "
+              << after.misses - before.misses << " misses, " << after.remote_frees - before.remote_frees
+              << " remote frees, peak reserved " << after.peak_bytes_reserved / 1024 << " KiB" << std::endl;
+    return 0;
+}
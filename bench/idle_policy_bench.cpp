@@ -0,0 +1,68 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <future>
+#include <algorithm>
+#include "ThreadPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Latency percentile in microseconds, samples must be sorted
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+// Submit tasks one at a time, gap apart, and record submit-to-start latency
+std::vector<double> measure(ThreadPool& pool, int samples, std::chrono::microseconds gap) {
+    std::vector<double> latencies;
+    latencies.reserve(samples);
+    for (int i = 0; i < samples; ++i) {
+        if (gap.count() > 0) {
+            // Sleep rather than spin so the workers really go idle
+            std::this_thread::sleep_for(gap);
+        }
+        auto submitted = Clock::now();
+        auto started = pool.enqueue([] { return Clock::now(); }).get();
+        latencies.push_back(std::chrono::duration<double, std::micro>(started - submitted).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+void runPolicy(const std::string& name, const IdlePolicy& policy, size_t threads, int samples) {
+    ThreadPoolOptions options;
+    options.idle = policy;
+    ThreadPool pool(threads, options);
+
+    // Warm up thread start-up and allocator caches
+    measure(pool, 100, std::chrono::microseconds(0));
+
+    for (auto gap : {std::chrono::microseconds(0), std::chrono::microseconds(50), std::chrono::microseconds(1000)}) {
+        std::vector<double> latencies = measure(pool, samples, gap);
+        std::cout << std::left << std::setw(18) << name << std::setw(10) << (std::to_string(gap.count()) + "us")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << percentile(latencies, 0.5)
+                  << std::setw(10) << percentile(latencies, 0.99)
+                  << std::setw(10) << latencies.back() << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    int samples = argc > 1 ? std::stoi(argv[1]) : 2000;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "Submit-to-start latency in microseconds, " << samples << " samples per row, "
+              << threads << " workers" << std::endl;
+    std::cout << std::left << std::setw(18) << "policy" << std::setw(10) << "gap"
+              << std::right << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+
+    runPolicy("park", IdlePolicy::park(), threads, samples);
+    runPolicy("yield->park", IdlePolicy::spinThenPark(0, 256), threads, samples);
+    runPolicy("spin->yield->park", IdlePolicy::spinThenPark(), threads, samples);
+    runPolicy("long spin", IdlePolicy::spinThenPark(1 << 20, 0), threads, samples);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include "ThreadPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Nanoseconds per empty task, posted from outside and run by the given number of workers
+double measure(size_t threads, size_t tasks) {
+    ThreadPool pool(threads);
+    auto start = Clock::now();
+    for (size_t i = 0; i < tasks; ++i) {
+        pool.post([] {});
+    }
+    pool.waitForCompletion();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / tasks;
+}
+
+// Built twice, against the library with and without THREADPOOL_METRICS; compare the two outputs
+int main(int argc, char** argv) {
+    size_t tasks = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "Metrics " << (THREADPOOL_METRICS ? "compiled in" : "compiled out")
+              << ", nanoseconds per empty task, " << tasks << " tasks per row" << std::endl;
+    std::cout << std::left << std::setw(12) << "threads" << std::right << std::setw(12) << "ns/task" << std::endl;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        // Best of three to keep scheduling noise out of the comparison
+        double best = measure(threads, tasks);
+        for (int round = 0; round < 2; ++round) {
+            best = std::min(best, measure(threads, tasks));
+        }
+        std::cout << std::left << std::setw(12) << threads << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << best << std::endl;
+    }
+
+    ThreadPool pool(maxThreads);
+    const int snapshots = 1000;
+    auto start = Clock::now();
+    for (int i = 0; i < snapshots; ++i) {
+        pool.snapshot();
+    }
+    std::cout << "snapshot(): " << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double, std::micro>(Clock::now() - start).count() / snapshots
+              << " us" << std::endl;
+    return 0;
+}
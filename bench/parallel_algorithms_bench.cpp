@@ -0,0 +1,112 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include "ParallelAlgorithms.h"
+
+#ifdef THREADPOOL_HAVE_STD_PAR
+#include <execution>
+#endif
+
+// Run fn several times and return the best wall time in milliseconds
+template<class F>
+double bestOf(int runs, F&& fn) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void report(const std::string& name, const std::string& variant, double ms, double serialMs) {
+    std::cout << std::left << std::setw(12) << name << std::setw(14) << variant
+              << std::right << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms"
+              << std::setw(9) << std::setprecision(2) << serialMs / ms << "x" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t size = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const int runs = 5;
+
+    ThreadPool pool(threads);
+    std::cout << "Parallel algorithms benchmark: " << size << " elements, " << threads << " workers" << std::endl;
+    std::cout << std::left << std::setw(12) << "algorithm" << std::setw(14) << "variant"
+              << std::right << std::setw(13) << "best" << std::setw(10) << "speedup" << std::endl;
+
+    std::vector<double> input(size);
+    std::iota(input.begin(), input.end(), 0.0);
+    std::vector<double> output(size);
+    auto work = [](double x) { return std::sqrt(x) * std::sin(x); };
+
+    // for_each / parallelFor
+    double serial = bestOf(runs, [&] {
+        for (size_t i = 0; i < size; ++i) output[i] = work(input[i]);
+    });
+    report("for", "serial", serial, serial);
+    report("for", "ThreadPool", bestOf(runs, [&] {
+        parallelFor(pool, size_t{0}, size, [&](size_t i) { output[i] = work(input[i]); });
+    }), serial);
+#ifdef THREADPOOL_HAVE_STD_PAR
+    report("for", "std::par", bestOf(runs, [&] {
+        std::for_each(std::execution::par, input.begin(), input.end(),
+                      [&](const double& x) { output[&x - input.data()] = work(x); });
+    }), serial);
+#endif
+
+    // reduce
+    volatile double sink = 0;
+    serial = bestOf(runs, [&] { sink = std::accumulate(input.begin(), input.end(), 0.0); });
+    report("reduce", "serial", serial, serial);
+    report("reduce", "ThreadPool", bestOf(runs, [&] {
+        sink = parallelReduce(pool, input.begin(), input.end(), 0.0);
+    }), serial);
+#ifdef THREADPOOL_HAVE_STD_PAR
+    report("reduce", "std::par", bestOf(runs, [&] {
+        sink = std::reduce(std::execution::par, input.begin(), input.end(), 0.0);
+    }), serial);
+#endif
+
+    // transform
+    serial = bestOf(runs, [&] { std::transform(input.begin(), input.end(), output.begin(), work); });
+    report("transform", "serial", serial, serial);
+    report("transform", "ThreadPool", bestOf(runs, [&] {
+        parallelTransform(pool, input.begin(), input.end(), output.begin(), work);
+    }), serial);
+#ifdef THREADPOOL_HAVE_STD_PAR
+    report("transform", "std::par", bestOf(runs, [&] {
+        std::transform(std::execution::par, input.begin(), input.end(), output.begin(), work);
+    }), serial);
+#endif
+
+    // sort, each run sorts a fresh copy of the same shuffled data
+    std::mt19937 gen(7);
+    std::vector<int> shuffled(size);
+    for (auto& x : shuffled) x = static_cast<int>(gen());
+    std::vector<int> data;
+    auto timeSort = [&](auto&& sortFn) {
+        double best = 1e300;
+        for (int i = 0; i < runs; ++i) {
+            data = shuffled;
+            best = std::min(best, bestOf(1, [&] { sortFn(); }));
+        }
+        return best;
+    };
+    serial = timeSort([&] { std::sort(data.begin(), data.end()); });
+    report("sort", "serial", serial, serial);
+    report("sort", "ThreadPool", timeSort([&] { parallelSort(pool, data.begin(), data.end()); }), serial);
+#ifdef THREADPOOL_HAVE_STD_PAR
+    report("sort", "std::par", timeSort([&] { std::sort(std::execution::par, data.begin(), data.end()); }), serial);
+#endif
+
+    (void)sink;
+    return 0;
+}
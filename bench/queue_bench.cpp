@@ -0,0 +1,106 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include "PriorityTaskQueue.h"
+
+using Clock = std::chrono::steady_clock;
+
+// PriorityTaskQueue behind a mutex, as ThreadPool uses it with the default backend
+class MutexQueue {
+public:
+    void push(TaskFunction&& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(std::move(task), TaskPriority::Normal);
+    }
+
+    bool pop(TaskFunction& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.pop(task);
+    }
+
+private:
+    std::mutex mutex;
+    PriorityTaskQueue queue;
+};
+
+// The lock-free backend needs no wrapper
+class LockFreeQueue {
+public:
+    void push(TaskFunction&& task) { queue.push(std::move(task), TaskPriority::Normal); }
+    bool pop(TaskFunction& task) { return queue.pop(task); }
+
+private:
+    LockFreePriorityTaskQueue queue;
+};
+
+// Millions of operations (push + pop) per second with the given producer and consumer counts
+template<class Queue>
+double measure(size_t producers, size_t consumers, size_t items) {
+    Queue queue;
+    std::atomic<size_t> consumed{0};
+    std::atomic<bool> go{false};
+    size_t perProducer = items / producers;
+    size_t total = perProducer * producers;
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < perProducer; ++i) {
+                queue.push(TaskFunction([] {}));
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            TaskFunction task;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (queue.pop(task)) {
+                    task();
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    auto start = Clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return 2.0 * total / seconds / 1e6;
+}
+
+int main(int argc, char** argv) {
+    size_t items = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t maxThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "Queue throughput in million operations per second, " << items << " tasks per row" << std::endl;
+    std::cout << std::left << std::setw(12) << "producers" << std::setw(12) << "consumers"
+              << std::right << std::setw(12) << "mutex" << std::setw(12) << "lock-free" << std::endl;
+
+    for (size_t producers = 1; producers <= maxThreads; producers *= 2) {
+        for (size_t consumers = 1; consumers <= maxThreads; consumers *= 2) {
+            double mutexRate = measure<MutexQueue>(producers, consumers, items);
+            double lockFreeRate = measure<LockFreeQueue>(producers, consumers, items);
+            std::cout << std::left << std::setw(12) << producers << std::setw(12) << consumers
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << mutexRate << std::setw(12) << lockFreeRate << std::endl;
+        }
+    }
+    return 0;
+}
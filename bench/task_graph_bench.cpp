@@ -0,0 +1,72 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include "TaskGraph.h"
+
+// Build a layered graph: every node depends on two nodes of the previous layer
+void buildLayered(TaskGraph& graph, int width, int depth, std::atomic<long>& counter) {
+    std::vector<TaskGraph::Node> previous;
+    for (int level = 0; level < depth; ++level) {
+        std::vector<TaskGraph::Node> current;
+        current.reserve(width);
+        for (int i = 0; i < width; ++i) {
+            auto node = graph.emplace([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+            if (!previous.empty()) {
+                node.succeed(previous[i]).succeed(previous[(i + 1) % width]);
+            }
+            current.push_back(node);
+        }
+        previous.swap(current);
+    }
+}
+
+template<class F>
+double timeMs(F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void runShape(ThreadPool& pool, const std::string& shape, int width, int depth, int iterations) {
+    std::atomic<long> counter{0};
+
+    double rebuild = timeMs([&] {
+        for (int i = 0; i < iterations; ++i) {
+            TaskGraph graph;
+            buildLayered(graph, width, depth, counter);
+            graph.run(pool).get();
+        }
+    });
+
+    TaskGraph graph;
+    buildLayered(graph, width, depth, counter);
+    double reuse = timeMs([&] {
+        for (int i = 0; i < iterations; ++i) {
+            graph.run(pool).get();
+        }
+    });
+
+    long nodes = static_cast<long>(width) * depth * iterations;
+    std::cout << std::left << std::setw(8) << shape << std::setw(12) << (std::to_string(width) + "x" + std::to_string(depth))
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << rebuild << " ms" << std::setw(12) << reuse << " ms"
+              << std::setw(12) << (nodes / reuse * 1000.0 / 1e6) << " Mnodes/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 50;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threads);
+
+    std::cout << "Task graph benchmark: " << iterations << " runs per shape, " << threads << " workers" << std::endl;
+    std::cout << std::left << std::setw(8) << "shape" << std::setw(12) << "size"
+              << std::right << std::setw(15) << "rebuild" << std::setw(15) << "reuse" << std::setw(21) << "reuse rate" << std::endl;
+    runShape(pool, "wide", 1000, 10, iterations);
+    runShape(pool, "deep", 10, 1000, iterations);
+    runShape(pool, "square", 100, 100, iterations);
+    return 0;
+}
@@ -0,0 +1,437 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+#include "ThreadPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+// One measured number; a run of the suite is a list of these
+struct Result {
+    std::string benchmark;
+    // Thread, producer, width or depth count, depending on the benchmark
+    size_t param = 0;
+    std::string metric;
+    std::string unit;
+    double value = 0;
+    bool higher_is_better = true;
+
+    std::string key() const { return benchmark + "/" + std::to_string(param) + "/" + metric; }
+};
+
+struct Config {
+    size_t tasks = 200000;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    int repeat = 3;
+    std::string format = "table";
+    std::string output;
+    std::string compare;
+    double tolerance = 10.0;
+    std::set<std::string> only;
+};
+
+// Median of the values measured over the repeats
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Value at fraction p of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+// 1, 2, 4, ... up to and including max
+std::vector<size_t> powersOfTwo(size_t max) {
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < max; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max);
+    return counts;
+}
+
+// Run fn repeat times, each returning seconds, and report tasks per second
+Result rate(const std::string& benchmark, size_t param, size_t tasks, int repeat, const std::function<double()>& fn) {
+    std::vector<double> rates;
+    for (int i = 0; i < repeat; ++i) {
+        rates.push_back(tasks / fn());
+    }
+    return {benchmark, param, "tasks_per_sec", "tasks/s", median(rates), true};
+}
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Empty tasks posted from one thread, for 1..threads workers
+void benchThroughput(const Config& config, std::vector<Result>& results) {
+    for (size_t threads : powersOfTwo(config.threads)) {
+        ThreadPool pool(threads);
+        results.push_back(rate("throughput", threads, config.tasks, config.repeat, [&] {
+            auto start = Clock::now();
+            for (size_t i = 0; i < config.tasks; ++i) {
+                pool.post([] {});
+            }
+            pool.waitForCompletion();
+            return secondsSince(start);
+        }));
+    }
+}
+
+// Time from submission until a worker starts the task, one task in flight at a time
+void benchLatency(const Config& config, std::vector<Result>& results) {
+    ThreadPool pool(config.threads);
+    size_t samples = std::max<size_t>(100, std::min<size_t>(config.tasks / 20, 20000));
+    std::map<std::string, std::vector<double>> repeats;
+    for (int r = 0; r < config.repeat; ++r) {
+        std::vector<double> latencies;
+        latencies.reserve(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            auto submitted = Clock::now();
+            auto started = pool.enqueue([] { return Clock::now(); }).get();
+            latencies.push_back(std::chrono::duration<double, std::micro>(started - submitted).count());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        repeats["p50_us"].push_back(percentile(latencies, 0.50));
+        repeats["p90_us"].push_back(percentile(latencies, 0.90));
+        repeats["p99_us"].push_back(percentile(latencies, 0.99));
+        repeats["max_us"].push_back(latencies.back());
+    }
+    for (const char* metric : {"p50_us", "p90_us", "p99_us", "max_us"}) {
+        results.push_back({"latency", config.threads, metric, "us", median(repeats[metric]), false});
+    }
+}
+
+// One submitter fans a batch out to the pool and waits for all of it
+void benchFanOut(const Config& config, std::vector<Result>& results) {
+    ThreadPool pool(config.threads);
+    for (size_t width : {size_t{16}, size_t{256}}) {
+        size_t rounds = std::max<size_t>(1, config.tasks / width / 4);
+        std::vector<double> perRound;
+        for (int r = 0; r < config.repeat; ++r) {
+            auto start = Clock::now();
+            for (size_t round = 0; round < rounds; ++round) {
+                std::atomic<size_t> sum{0};
+                std::vector<std::function<void()>> batch(width, [&sum] {
+                    sum.fetch_add(1, std::memory_order_relaxed);
+                });
+                pool.submitBatch(std::move(batch)).get();
+            }
+            perRound.push_back(secondsSince(start) * 1e6 / rounds);
+        }
+        results.push_back({"fanout", width, "us_per_round", "us", median(perRound), false});
+    }
+}
+
+// Several threads submit at once, contending for the injection queue
+void benchProducers(const Config& config, std::vector<Result>& results) {
+    ThreadPool pool(config.threads);
+    for (size_t producers : powersOfTwo(std::max<size_t>(2, config.threads))) {
+        size_t perProducer = config.tasks / producers;
+        results.push_back(rate("producers", producers, perProducer * producers, config.repeat, [&] {
+            std::atomic<bool> go{false};
+            std::vector<std::thread> threads;
+            for (size_t p = 0; p < producers; ++p) {
+                threads.emplace_back([&] {
+                    while (!go) {
+                        std::this_thread::yield();
+                    }
+                    for (size_t i = 0; i < perProducer; ++i) {
+                        pool.post([] {});
+                    }
+                });
+            }
+            auto start = Clock::now();
+            go = true;
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            pool.waitForCompletion();
+            return secondsSince(start);
+        }));
+    }
+}
+
+// Binary tree of tasks, every task but the leaves submits two more from inside the pool
+void spawnTree(ThreadPool& pool, int depth) {
+    if (depth > 0) {
+        pool.post([&pool, depth] { spawnTree(pool, depth - 1); });
+        pool.post([&pool, depth] { spawnTree(pool, depth - 1); });
+    }
+}
+
+void benchNested(const Config& config, std::vector<Result>& results) {
+    ThreadPool pool(config.threads);
+    int depth = std::max(1, static_cast<int>(std::log2(static_cast<double>(config.tasks))) - 1);
+    size_t tasks = (size_t{1} << (depth + 1)) - 1;
+    results.push_back(rate("nested", static_cast<size_t>(depth), tasks, config.repeat, [&] {
+        auto start = Clock::now();
+        pool.post([&pool, depth] { spawnTree(pool, depth); });
+        pool.waitForCompletion();
+        return secondsSince(start);
+    }));
+}
+
+void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "benchmark,param,metric,unit,value,better\n";
+    for (const Result& r : results) {
+        out << r.benchmark << "," << r.param << "," << r.metric << "," << r.unit << ","
+            << std::setprecision(10) << r.value << "," << (r.higher_is_better ? "higher" : "lower") << "\n";
+    }
+}
+
+void writeJson(std::ostream& out, const Config& config, const std::vector<Result>& results) {
+    out << "{\n  \"config\": {\"tasks\": " << config.tasks << ", \"threads\": " << config.threads
+        << ", \"repeat\": " << config.repeat
+#ifdef THREADPOOL_LOCKFREE_QUEUE
+        << ", \"queue_backend\": \"lockfree\""
+#else
+        << ", \"queue_backend\": \"mutex\""
+#endif
+        << ", \"metrics\": " << (THREADPOOL_METRICS ? "true" : "false") << "},\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"benchmark\": \"" << r.benchmark << "\", \"param\": " << r.param
+            << ", \"metric\": \"" << r.metric << "\", \"unit\": \"" << r.unit << "\", \"value\": "
+            << std::setprecision(10) << r.value << ", \"better\": \"" << (r.higher_is_better ? "higher" : "lower")
+            << "\"}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeTable(std::ostream& out, const std::vector<Result>& results) {
+    out << std::left << std::setw(12) << "benchmark" << std::setw(8) << "param" << std::setw(16) << "metric"
+        << std::right << std::setw(16) << "value" << "  unit" << std::endl;
+    for (const Result& r : results) {
+        out << std::left << std::setw(12) << r.benchmark << std::setw(8) << r.param << std::setw(16) << r.metric
+            << std::right << std::setw(16) << std::fixed << std::setprecision(2) << r.value
+            << "  " << r.unit << std::endl;
+    }
+}
+
+// Fields of one flat JSON object {"key": "text" or number, ...}, as strings
+std::map<std::string, std::string> parseFlatObject(const std::string& text) {
+    std::map<std::string, std::string> fields;
+    size_t pos = 0;
+    while ((pos = text.find('"', pos)) != std::string::npos) {
+        size_t keyEnd = text.find('"', pos + 1);
+        size_t colon = text.find(':', keyEnd);
+        if (keyEnd == std::string::npos || colon == std::string::npos) {
+            break;
+        }
+        std::string key = text.substr(pos + 1, keyEnd - pos - 1);
+        size_t valueStart = text.find_first_not_of(" \t\n", colon + 1);
+        size_t valueEnd;
+        std::string value;
+        if (text[valueStart] == '"') {
+            valueEnd = text.find('"', valueStart + 1);
+            value = text.substr(valueStart + 1, valueEnd - valueStart - 1);
+            ++valueEnd;
+        } else {
+            valueEnd = text.find_first_of(",}", valueStart);
+            value = text.substr(valueStart, valueEnd - valueStart);
+        }
+        fields[key] = value;
+        pos = valueEnd;
+    }
+    return fields;
+}
+
+// Results of a previous run written with --format csv or json
+std::vector<Result> loadResults(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("cannot open baseline " + path);
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    std::vector<Result> results;
+    auto add = [&results](std::map<std::string, std::string>& fields) {
+        Result r;
+        r.benchmark = fields["benchmark"];
+        r.param = std::stoul(fields["param"]);
+        r.metric = fields["metric"];
+        r.unit = fields["unit"];
+        r.value = std::stod(fields["value"]);
+        r.higher_is_better = fields["better"] != "lower";
+        results.push_back(r);
+    };
+
+    size_t resultsStart = text.find("\"results\"");
+    if (resultsStart != std::string::npos) {
+        size_t open = resultsStart;
+        while ((open = text.find('{', open)) != std::string::npos) {
+            size_t close = text.find('}', open);
+            auto fields = parseFlatObject(text.substr(open, close - open + 1));
+            add(fields);
+            open = close;
+        }
+        return results;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    std::getline(lines, line);   // header
+    const char* names[] = {"benchmark", "param", "metric", "unit", "value", "better"};
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::map<std::string, std::string> fields;
+        std::istringstream cells(line);
+        std::string cell;
+        for (const char* name : names) {
+            std::getline(cells, cell, ',');
+            fields[name] = cell;
+        }
+        add(fields);
+    }
+    return results;
+}
+
+// Print current against baseline, returns the number of regressions beyond the tolerance
+int compareResults(const std::vector<Result>& baseline, const std::vector<Result>& current, double tolerance) {
+    std::map<std::string, const Result*> previous;
+    for (const Result& r : baseline) {
+        previous[r.key()] = &r;
+    }
+
+    int regressions = 0;
+    std::cout << "\nComparison against baseline, tolerance " << tolerance << "%" << std::endl;
+    std::cout << std::left << std::setw(34) << "result" << std::right << std::setw(14) << "baseline"
+              << std::setw(14) << "current" << std::setw(10) << "change" << "  status" << std::endl;
+    for (const Result& r : current) {
+        auto it = previous.find(r.key());
+        std::cout << std::left << std::setw(34) << r.key() << std::right << std::fixed << std::setprecision(2);
+        if (it == previous.end()) {
+            std::cout << std::setw(14) << "-" << std::setw(14) << r.value << std::setw(10) << "-" << "  new" << std::endl;
+            continue;
+        }
+        double before = it->second->value;
+        double change = before == 0 ? 0 : (r.value - before) / before * 100.0;
+        // Positive when the result got better
+        double gain = r.higher_is_better ? change : -change;
+        const char* status = gain < -tolerance ? "REGRESSION" : (gain > tolerance ? "improved" : "ok");
+        if (gain < -tolerance) {
+            ++regressions;
+        }
+        std::cout << std::setw(14) << before << std::setw(14) << r.value << std::setw(9) << change << "%  "
+                  << status << std::endl;
+    }
+    return regressions;
+}
+
+void usage() {
+    std::cout << "Usage: threadpool_bench [--tasks N] [--threads N] [--repeat N]\n"
+                 "                        [--only throughput,latency,fanout,producers,nested]\n"
+                 "                        [--format table|csv|json] [--output FILE]\n"
+                 "                        [--compare BASELINE] [--tolerance PERCENT]\n"
+                 "Exits with status 2 if --compare finds a regression beyond the tolerance." << std::endl;
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+            if (arg == "--tasks") {
+                config.tasks = std::stoul(next());
+            } else if (arg == "--threads") {
+                config.threads = std::max<size_t>(1, std::stoul(next()));
+            } else if (arg == "--repeat") {
+                config.repeat = std::max(1, std::stoi(next()));
+            } else if (arg == "--format") {
+                config.format = next();
+            } else if (arg == "--output") {
+                config.output = next();
+            } else if (arg == "--compare") {
+                config.compare = next();
+            } else if (arg == "--tolerance") {
+                config.tolerance = std::stod(next());
+            } else if (arg == "--only") {
+                std::istringstream names(next());
+                std::string name;
+                while (std::getline(names, name, ',')) {
+                    config.only.insert(name);
+                }
+            } else {
+                usage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+        if (config.format != "table" && config.format != "csv" && config.format != "json") {
+            throw std::invalid_argument("unknown format " + config.format);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "threadpool_bench: " << e.what() << std::endl;
+        usage();
+        return 1;
+    }
+
+    const std::pair<const char*, void (*)(const Config&, std::vector<Result>&)> suite[] = {
+        {"throughput", benchThroughput},
+        {"latency", benchLatency},
+        {"fanout", benchFanOut},
+        {"producers", benchProducers},
+        {"nested", benchNested},
+    };
+
+    std::vector<Result> results;
+    for (const auto& bench : suite) {
+        if (config.only.empty() || config.only.count(bench.first)) {
+            std::cerr << "running " << bench.first << "..." << std::endl;
+            bench.second(config, results);
+        }
+    }
+
+    // Machine-readable output goes to the file, or replaces the table on stdout
+    std::ofstream file;
+    if (!config.output.empty()) {
+        file.open(config.output);
+        if (!file) {
+            std::cerr << "threadpool_bench: cannot write " << config.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = config.output.empty() ? std::cout : file;
+    if (config.format == "csv") {
+        writeCsv(out, results);
+    } else if (config.format == "json") {
+        writeJson(out, config, results);
+    }
+    if (config.format == "table" || !config.output.empty()) {
+        writeTable(std::cout, results);
+    }
+
+    if (!config.compare.empty()) {
+        try {
+            int regressions = compareResults(loadResults(config.compare), results, config.tolerance);
+            std::cout << regressions << " regression(s)" << std::endl;
+            return regressions > 0 ? 2 : 0;
+        } catch (const std::exception& e) {
+            std::cerr << "threadpool_bench: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef CANCELLATION_TOKEN_H
+#define CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <exception>
+#include <memory>
+
+// Error stored in the future of a task that was skipped instead of run
+class TaskCancelled : public std::exception {
+public:
+    enum class Reason {
+        // Its CancellationToken was cancelled before a worker got to it
+        Cancelled,
+        // It was dequeued after its deadline
+        DeadlineExpired
+    };
+
+    explicit TaskCancelled(Reason reason) : why(reason) {}
+
+    Reason reason() const { return why; }
+
+    const char* what() const noexcept override {
+        return why == Reason::Cancelled ? "task cancelled" : "task deadline expired";
+    }
+
+private:
+    Reason why;
+};
+
+// Read side of a cancellation flag, passed along with submitted tasks
+// A default-constructed token is never cancelled
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    bool isCancelled() const {
+        return flag && flag->load(std::memory_order_acquire);
+    }
+
+    // Whether the token is tied to a CancellationSource at all
+    explicit operator bool() const { return flag != nullptr; }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<std::atomic<bool>> flag) : flag(std::move(flag)) {}
+
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+// Owner of a cancellation flag, e.g. one per client request
+// Cancelling is O(1): queued tasks holding its tokens are skipped when dequeued,
+// running tasks can poll isCancelled() to stop early
+class CancellationSource {
+public:
+    CancellationSource() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { flag->store(true, std::memory_order_release); }
+
+    bool isCancelled() const { return flag->load(std::memory_order_acquire); }
+
+    CancellationToken token() const { return CancellationToken(flag); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+#endif // CANCELLATION_TOKEN_H
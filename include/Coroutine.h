@@ -0,0 +1,318 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "Coroutine.h requires C++20 coroutine support, see THREADPOOL_ENABLE_COROUTINES"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include "ThreadPool.h"
+
+// Awaitable returned by ThreadPool::schedule(), resumes the awaiting coroutine on a pool worker
+// If the pool drops the resumption (it is stopped, or clearTasks() removes it), the coroutine
+// is resumed on the dropping thread and co_await throws std::future_errc::broken_promise
+class ScheduleOperation {
+public:
+    explicit ScheduleOperation(ThreadPool& pool) : pool(pool) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    // The overflow policy of a bounded pool would run the coroutine inline or throw, so it is bypassed
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        try {
+            pool.submitUnbounded(TaskFunction([resumer = Resumer(this, awaiting)]() mutable { resumer.resume(); }));
+        } catch(...) {
+            // The refused task's resumer already resumed the coroutine with the error
+        }
+    }
+
+    void await_resume() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // Owns the suspended coroutine on behalf of the queued task, resumes it with an error if destroyed unrun
+    class Resumer {
+    public:
+        Resumer(ScheduleOperation* operation, std::coroutine_handle<> awaiting)
+            : operation(operation), awaiting(awaiting) {}
+        Resumer(Resumer&& other) noexcept
+            : operation(other.operation), awaiting(std::exchange(other.awaiting, {})) {}
+        Resumer& operator=(Resumer&&) = delete;
+
+        ~Resumer() {
+            if (awaiting) {
+                operation->error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+                std::exchange(awaiting, {}).resume();
+            }
+        }
+
+        void resume() { std::exchange(awaiting, {}).resume(); }
+
+    private:
+        // Lives in the suspended coroutine's frame
+        ScheduleOperation* operation;
+        std::coroutine_handle<> awaiting;
+    };
+
+    ThreadPool& pool;
+    std::exception_ptr error;
+};
+
+inline ScheduleOperation ThreadPool::schedule() {
+    return ScheduleOperation(*this);
+}
+
+template<class T> class Task;
+
+namespace detail {
+
+// State shared by every task promise: who to resume on completion, and the error
+class TaskPromiseBase {
+public:
+    // Transfer to the awaiting coroutine instead of resuming it nested
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<class Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+            std::coroutine_handle<> next = finished.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    // Lazy: the body starts only once the task is awaited
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    void setContinuation(std::coroutine_handle<> awaiting) noexcept { continuation = awaiting; }
+
+protected:
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+};
+
+template<class T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template<class U>
+    void return_value(U&& value) {
+        result.emplace(std::forward<U>(value));
+    }
+
+    // The value of the finished task, rethrows its exception
+    T takeResult() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*result);
+    }
+
+private:
+    std::optional<T> result;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void takeResult() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// Signalled by the coroutine that syncWait() blocks on
+class SyncWaitEvent {
+public:
+    void set() {
+        // Notify under the lock: the waiter destroys the event as soon as it sees done
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        ready.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return done; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool done = false;
+};
+
+// Top-level coroutine driving a task for syncWait()
+class SyncWaitTask {
+public:
+    struct promise_type {
+        SyncWaitEvent* event = nullptr;
+
+        SyncWaitTask get_return_object() noexcept {
+            return SyncWaitTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        auto final_suspend() const noexcept {
+            struct NotifyAwaiter {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> finished) const noexcept {
+                    finished.promise().event->set();
+                }
+                void await_resume() const noexcept {}
+            };
+            return NotifyAwaiter{};
+        }
+
+        void return_void() const noexcept {}
+
+        // The awaited task stores its own exception, nothing can escape here
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    SyncWaitTask(SyncWaitTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    SyncWaitTask(const SyncWaitTask&) = delete;
+    SyncWaitTask& operator=(const SyncWaitTask&) = delete;
+
+    ~SyncWaitTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Start on the calling thread and block until the coroutine finished
+    void run() {
+        SyncWaitEvent event;
+        handle.promise().event = &event;
+        handle.resume();
+        event.wait();
+    }
+
+private:
+    explicit SyncWaitTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+} // namespace detail
+
+// Lazily started coroutine producing a T.
+//
+// The body runs when the task is first awaited, on the awaiting thread; a
+// co_await pool.schedule() inside moves it onto the pool. Completion resumes
+// the awaiting coroutine through symmetric transfer instead of a nested
+// resume(), so chains of tasks never block a thread. Exceptions are
+// rethrown by co_await. Move-only, awaited at most once.
+template<class T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Start the task and resume the awaiting coroutine with its result
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> task;
+
+            bool await_ready() const noexcept { return task.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                task.promise().setContinuation(awaiting);
+                return task;
+            }
+
+            T await_resume() { return task.promise().takeResult(); }
+        };
+        return Awaiter{handle};
+    }
+
+    auto operator co_await() & noexcept {
+        return std::move(*this).operator co_await();
+    }
+
+private:
+    friend class detail::TaskPromise<T>;
+    template<class U> friend U syncWait(Task<U> task);
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail {
+
+template<class T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Await a task without taking its result, syncWait() reads it afterwards
+template<class Handle>
+SyncWaitTask awaitCompletion(Handle task) {
+    struct CompletionAwaiter {
+        Handle task;
+        bool await_ready() const noexcept { return task.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            task.promise().setContinuation(awaiting);
+            return task;
+        }
+        void await_resume() const noexcept {}
+    };
+    co_await CompletionAwaiter{task};
+}
+
+} // namespace detail
+
+// Run a task to completion from non-coroutine code, blocking the calling thread
+// Must not be called on a pool worker whose pool the task needs to make progress
+template<class T>
+T syncWait(Task<T> task) {
+    detail::awaitCompletion(task.handle).run();
+    return task.handle.promise().takeResult();
+}
+
+#endif // COROUTINE_H
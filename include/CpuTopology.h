@@ -0,0 +1,49 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// One NUMA node and the logical CPUs that belong to it
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+// NUMA layout of the machine as reported by Linux sysfs.
+//
+// detect() reads /sys/devices/system/node/node*/cpulist. Without that
+// directory (other systems, containers hiding it) it reports a single node
+// holding every CPU, so NUMA-aware code degrades to one group.
+class CpuTopology {
+public:
+    // Single node with CPUs [0, hardware_concurrency)
+    CpuTopology();
+    explicit CpuTopology(std::vector<NumaNode> nodes);
+
+    // Read the topology below root, falls back to a single node
+    static CpuTopology detect(const std::string& root = "/sys/devices/system/node");
+
+    // Parse a sysfs CPU list such as "0-3,8-11", returns an empty list on malformed input
+    static std::vector<int> parseCpuList(const std::string& text);
+
+    // Bind the calling thread to the given CPUs, returns false if unsupported or refused
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    // CPU the calling thread runs on, -1 if unknown
+    static int currentCpu();
+
+    const std::vector<NumaNode>& nodes() const { return node_list; }
+    size_t nodeCount() const { return node_list.size(); }
+
+    // Index into nodes() of the node owning cpu, 0 if unknown
+    size_t nodeIndexOfCpu(int cpu) const;
+
+private:
+    std::vector<NumaNode> node_list;
+    // Node index per CPU number, for nodeIndexOfCpu()
+    std::vector<size_t> cpu_to_node;
+};
+
+#endif // CPU_TOPOLOGY_H
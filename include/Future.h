@@ -0,0 +1,526 @@
+#ifndef FUTURE_H
+#define FUTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// Where a continuation runs once its antecedent is ready
+enum class Continuation {
+    // Posted to the pool as a new task
+    Pool,
+    // Run directly on the thread that completed the antecedent, for cheap continuations
+    Inline
+};
+
+template<class T> class Future;
+
+namespace detail {
+
+// Stored value of a future, void results carry no data
+struct Unit {};
+template<class T>
+using FutureValue = std::conditional_t<std::is_void<T>::value, Unit, T>;
+
+// Shared state between the producer of a result and its Future
+template<class T>
+class FutureState {
+public:
+    void setValue(FutureValue<T> value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        result.emplace(std::move(value));
+        finish(lock);
+    }
+
+    void setException(std::exception_ptr e) {
+        std::unique_lock<std::mutex> lock(mutex);
+        error = std::move(e);
+        finish(lock);
+    }
+
+    // Run callback once the state is ready, right away if it already is
+    void onReady(TaskFunction callback) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!ready) {
+            continuation = std::move(callback);
+            return;
+        }
+        lock.unlock();
+        callback();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready_cv.wait(lock, [this] { return ready; });
+    }
+
+    bool isReady() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ready;
+    }
+
+    // Result accessors, only valid once the state is ready
+    FutureValue<T>& value() { return *result; }
+    const std::exception_ptr& exception() const { return error; }
+
+private:
+    void finish(std::unique_lock<std::mutex>& lock) {
+        ready = true;
+        TaskFunction callback = std::move(continuation);
+        lock.unlock();
+        ready_cv.notify_all();
+        if (callback) {
+            callback();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready_cv;
+    bool ready = false;
+    std::optional<FutureValue<T>> result;
+    std::exception_ptr error;
+    // At most one continuation: a Future is consumed by then() and the combinators
+    TaskFunction continuation;
+};
+
+// Shared states come from the slab pool like the ones of enqueue()
+template<class T>
+std::shared_ptr<FutureState<T>> makeFutureState() {
+    return std::allocate_shared<FutureState<T>>(SlabAllocator<FutureState<T>>());
+}
+
+// Producing side of a FutureState held by a queued task or continuation
+// If it is destroyed unrun (e.g. by clearTasks()) the future fails with broken_promise, like std::promise
+template<class T>
+class FuturePromise {
+public:
+    explicit FuturePromise(std::shared_ptr<FutureState<T>> state) : state(std::move(state)) {}
+    FuturePromise(FuturePromise&&) noexcept = default;
+    FuturePromise& operator=(FuturePromise&&) = delete;
+
+    ~FuturePromise() {
+        if (state) {
+            state->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    // Take the state over to complete it
+    std::shared_ptr<FutureState<T>> take() { return std::move(state); }
+
+private:
+    std::shared_ptr<FutureState<T>> state;
+};
+
+// Store the result of fn() in result, Unit for void; exceptions propagate
+template<class R, class Fn>
+void captureResult(std::optional<FutureValue<R>>& result, Fn&& fn) {
+    if constexpr (std::is_void<R>::value) {
+        fn();
+        result.emplace();
+    } else {
+        result.emplace(fn());
+    }
+}
+
+// Result of a continuation taking the value of a Future<T>
+template<class T, class F, bool = std::is_void<T>::value>
+struct ContinuationResult {
+    using type = std::invoke_result_t<F&, T>;
+};
+
+template<class T, class F>
+struct ContinuationResult<T, F, true> {
+    using type = std::invoke_result_t<F&>;
+};
+
+// Continuations returning a Future are flattened into the returned one
+template<class R>
+struct UnwrapFuture {
+    using type = R;
+    static constexpr bool nested = false;
+};
+
+template<class U>
+struct UnwrapFuture<Future<U>> {
+    using type = U;
+    static constexpr bool nested = true;
+};
+
+// Call f(index, item) for each item, the index as a compile-time constant
+template<class F, size_t... I, class... Items>
+void forEachIndexed(F& f, std::index_sequence<I...>, Items&... items) {
+    (f(std::integral_constant<size_t, I>(), items), ...);
+}
+
+// Access to the internals of Future for the combinators
+struct FutureAccess {
+    template<class T>
+    static std::shared_ptr<FutureState<T>>& state(Future<T>& future) { return future.state; }
+
+    template<class T>
+    static ThreadPool* pool(const Future<T>& future) { return future.pool; }
+
+    template<class T>
+    static Future<T> make(std::shared_ptr<FutureState<T>> state, ThreadPool* pool) {
+        return Future<T>(std::move(state), pool);
+    }
+};
+
+} // namespace detail
+
+// Future returned by ThreadPool::async() that can be composed without blocking.
+//
+// then() attaches a continuation that receives the value once it is ready
+// and returns a new Future for the continuation's result; by default it is
+// posted to the pool, Continuation::Inline runs it on the completing thread.
+// If the antecedent failed the continuation is skipped and the exception is
+// propagated. Like std::future it is move-only and consumed by get(), then()
+// and the combinators.
+template<class T>
+class Future {
+public:
+    using value_type = T;
+
+    Future() = default;
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    // Whether the future refers to a shared state
+    bool valid() const { return state != nullptr; }
+
+    // Whether the result is available, get() would not block
+    bool isReady() const {
+        checkValid();
+        return state->isReady();
+    }
+
+    // Block until the result is available
+    // Prefer then() on pool threads, a blocked worker cannot run other tasks
+    void wait() const {
+        checkValid();
+        state->wait();
+    }
+
+    // Wait for and return the result, rethrows the stored exception
+    T get() {
+        checkValid();
+        auto ready = std::move(state);
+        ready->wait();
+        if (ready->exception()) {
+            std::rethrow_exception(ready->exception());
+        }
+        if constexpr (!std::is_void<T>::value) {
+            return std::move(ready->value());
+        }
+    }
+
+    // Run f with the value once it is ready, posted to the pool
+    template<class F>
+    auto then(F&& f) {
+        return then(Continuation::Pool, std::forward<F>(f));
+    }
+
+    // Run f with the value once it is ready, on the pool or inline
+    template<class F>
+    auto then(Continuation policy, F&& f)
+        -> Future<typename detail::UnwrapFuture<
+               typename detail::ContinuationResult<T, std::decay_t<F>>::type>::type>;
+
+private:
+    friend class ThreadPool;
+    friend struct detail::FutureAccess;
+    template<class> friend class Future;
+
+    Future(std::shared_ptr<detail::FutureState<T>> state, ThreadPool* pool)
+        : state(std::move(state)), pool(pool) {}
+
+    void checkValid() const {
+        if (!state) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+    }
+
+    // Complete target with the result of this future once it is ready
+    template<class U>
+    void forwardTo(std::shared_ptr<detail::FutureState<U>> target) {
+        if (!state) {
+            target->setException(std::make_exception_ptr(std::future_error(std::future_errc::no_state)));
+            return;
+        }
+        auto source = std::move(state);
+        auto& ready = *source;
+        ready.onReady([source = std::move(source), target = std::move(target)]() mutable {
+            if (source->exception()) {
+                target->setException(source->exception());
+            } else {
+                target->setValue(std::move(source->value()));
+            }
+        });
+    }
+
+    std::shared_ptr<detail::FutureState<T>> state;
+    // Pool that runs the continuations, null for inline-only futures
+    ThreadPool* pool = nullptr;
+};
+
+// Result of whenAny(): the index of the first future to complete, and that future (ready)
+template<class T>
+struct WhenAnyResult {
+    size_t index;
+    Future<T> future;
+};
+
+template<class T>
+template<class F>
+auto Future<T>::then(Continuation policy, F&& f)
+    -> Future<typename detail::UnwrapFuture<
+           typename detail::ContinuationResult<T, std::decay_t<F>>::type>::type> {
+
+    using result_type = typename detail::ContinuationResult<T, std::decay_t<F>>::type;
+    using value_type = typename detail::UnwrapFuture<result_type>::type;
+
+    checkValid();
+    auto next = detail::makeFutureState<value_type>();
+    auto source = std::move(state);
+    ThreadPool* target = pool;
+
+    TaskFunction run = [target, source, promise = detail::FuturePromise<value_type>(next),
+                        fn = std::forward<F>(f)]() mutable {
+        auto next = promise.take();
+        if (source->exception()) {
+            next->setException(source->exception());
+            return;
+        }
+
+        std::optional<detail::FutureValue<result_type>> result;
+        try {
+            detail::captureResult<result_type>(result, [&]() -> result_type {
+                if constexpr (std::is_void<T>::value) {
+                    return fn();
+                } else {
+                    return fn(std::move(source->value()));
+                }
+            });
+        } catch(...) {
+            if (target) {
+                target->markTaskFailed();
+            }
+            next->setException(std::current_exception());
+            return;
+        }
+
+        if constexpr (detail::UnwrapFuture<result_type>::nested) {
+            result->forwardTo(next);
+        } else {
+            next->setValue(std::move(*result));
+        }
+    };
+
+    auto& antecedent = *source;
+    if (policy == Continuation::Inline || !target) {
+        antecedent.onReady(std::move(run));
+    } else {
+        // Continues accepted work, so a bounded pool may not refuse it or run it inline
+        // A refused or cleared continuation breaks the promise of next
+        antecedent.onReady([target, task = std::move(run)]() mutable {
+            try {
+                target->submitUnbounded(std::move(task));
+            } catch(...) {
+                target->markTaskFailed();
+            }
+        });
+    }
+    return Future<value_type>(std::move(next), target);
+}
+
+// Future that completes once all futures have, with their values in order
+// Fails with the first exception to arrive, but only after every future completed
+template<class T>
+auto whenAll(std::vector<Future<T>> futures)
+    -> Future<std::conditional_t<std::is_void<T>::value, void, std::vector<T>>> {
+
+    using result_type = std::conditional_t<std::is_void<T>::value, void, std::vector<T>>;
+
+    struct AllState {
+        explicit AllState(size_t count) : remaining(count), values(count) {}
+        std::atomic<size_t> remaining;
+        std::vector<std::optional<detail::FutureValue<T>>> values;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::shared_ptr<detail::FutureState<result_type>> done = detail::makeFutureState<result_type>();
+    };
+
+    ThreadPool* pool = futures.empty() ? nullptr : detail::FutureAccess::pool(futures.front());
+    auto all = std::make_shared<AllState>(futures.size());
+    Future<result_type> result = detail::FutureAccess::make(all->done, pool);
+    if (futures.empty()) {
+        all->done->setValue({});
+        return result;
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto source = std::move(detail::FutureAccess::state(futures[i]));
+        if (!source) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        auto& ready = *source;
+        ready.onReady([all, i, source = std::move(source)] {
+            if (source->exception()) {
+                // Keep only the first error, published by the decrement below
+                if (!all->failed.exchange(true)) {
+                    all->error = source->exception();
+                }
+            } else {
+                all->values[i].emplace(std::move(source->value()));
+            }
+
+            if (all->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            if (all->error) {
+                all->done->setException(all->error);
+            } else if constexpr (std::is_void<T>::value) {
+                all->done->setValue({});
+            } else {
+                std::vector<T> values;
+                values.reserve(all->values.size());
+                for (auto& value : all->values) {
+                    values.push_back(std::move(*value));
+                }
+                all->done->setValue(std::move(values));
+            }
+        });
+    }
+    return result;
+}
+
+// Future that completes once all futures have, with a tuple of their values (Unit for void)
+template<class... Ts>
+auto whenAll(Future<Ts>... futures)
+    -> Future<std::tuple<detail::FutureValue<Ts>...>> {
+
+    using result_type = std::tuple<detail::FutureValue<Ts>...>;
+
+    struct AllState {
+        std::atomic<size_t> remaining{sizeof...(Ts)};
+        std::tuple<std::optional<detail::FutureValue<Ts>>...> values;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::shared_ptr<detail::FutureState<result_type>> done = detail::makeFutureState<result_type>();
+    };
+
+    ThreadPool* pools[] = {nullptr, detail::FutureAccess::pool(futures)...};
+    auto all = std::make_shared<AllState>();
+    Future<result_type> result = detail::FutureAccess::make(all->done, sizeof...(Ts) ? pools[1] : nullptr);
+
+    auto finish = [all] {
+        if (all->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if (all->error) {
+            all->done->setException(all->error);
+        } else {
+            all->done->setValue(std::apply([](auto&... values) {
+                return result_type(std::move(*values)...);
+            }, all->values));
+        }
+    };
+
+    auto attach = [&all, &finish](auto index, auto& future) {
+        auto source = std::move(detail::FutureAccess::state(future));
+        if (!source) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        auto& ready = *source;
+        ready.onReady([all, finish, source = std::move(source)] {
+            if (source->exception()) {
+                if (!all->failed.exchange(true)) {
+                    all->error = source->exception();
+                }
+            } else {
+                std::get<decltype(index)::value>(all->values).emplace(std::move(source->value()));
+            }
+            finish();
+        });
+    };
+
+    if constexpr (sizeof...(Ts) == 0) {
+        all->done->setValue({});
+    } else {
+        detail::forEachIndexed(attach, std::index_sequence_for<Ts...>(), futures...);
+    }
+    return result;
+}
+
+// Future that completes with the first of the futures to complete, whether it succeeded or not
+template<class T>
+auto whenAny(std::vector<Future<T>> futures) -> Future<WhenAnyResult<T>> {
+    if (futures.empty()) {
+        throw std::invalid_argument("whenAny needs at least one future");
+    }
+
+    struct AnyState {
+        std::atomic<bool> decided{false};
+        std::shared_ptr<detail::FutureState<WhenAnyResult<T>>> done =
+            detail::makeFutureState<WhenAnyResult<T>>();
+    };
+
+    ThreadPool* pool = detail::FutureAccess::pool(futures.front());
+    auto any = std::make_shared<AnyState>();
+    Future<WhenAnyResult<T>> result = detail::FutureAccess::make(any->done, pool);
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto source = std::move(detail::FutureAccess::state(futures[i]));
+        if (!source) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        auto& ready = *source;
+        ready.onReady([any, i, pool, source = std::move(source)]() mutable {
+            if (!any->decided.exchange(true)) {
+                any->done->setValue(WhenAnyResult<T>{i, detail::FutureAccess::make(std::move(source), pool)});
+            }
+        });
+    }
+    return result;
+}
+
+template<class F, class... Args>
+auto ThreadPool::async(F&& f, Args&&... args)
+    -> Future<std::invoke_result_t<F, Args...>> {
+
+    using return_type = std::invoke_result_t<F, Args...>;
+
+    auto state = detail::makeFutureState<return_type>();
+    post([this, promise = detail::FuturePromise<return_type>(state),
+          fn = std::forward<F>(f),
+          bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        auto state = promise.take();
+        std::optional<detail::FutureValue<return_type>> result;
+        try {
+            detail::captureResult<return_type>(result, [&]() -> return_type {
+                return std::apply(fn, bound);
+            });
+        } catch(...) {
+            markTaskFailed();
+            state->setException(std::current_exception());
+            return;
+        }
+        state->setValue(std::move(*result));
+    });
+    return Future<return_type>(std::move(state), this);
+}
+
+#endif // FUTURE_H
@@ -0,0 +1,106 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include "MpmcRingQueue.h"
+
+// Severity of a log record, Off disables logging when used as a threshold
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// One log message, kept unformatted so that queuing it is cheap
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    // system_clock nanoseconds since the epoch
+    int64_t time = 0;
+    // Static text; each "{}" is replaced by the next of values
+    const char* message = "";
+    int64_t values[2] = {0, 0};
+    // Dynamic text appended to the message (e.g. an exception's what()), usually empty
+    std::string detail;
+};
+
+// Name of a level, e.g. "INFO"
+const char* toString(LogLevel level);
+
+// Render a record as one line without a newline: "<time> <LEVEL> <message>[: <detail>]"
+std::string formatLogRecord(const LogRecord& record);
+
+// Receiver of log records; write() may be called from several threads at once
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+};
+
+// Discards every record, what a pool without a configured sink behaves like
+class NullLogSink : public LogSink {
+public:
+    void write(const LogRecord&) override {}
+};
+
+// Formats each record on the calling thread and writes it to a stream
+class StreamLogSink : public LogSink {
+public:
+    explicit StreamLogSink(std::ostream& out) : out(out) {}
+
+    void write(const LogRecord& record) override;
+
+private:
+    std::ostream& out;
+    std::mutex mutex;
+};
+
+// Hands records to another sink on a background thread.
+//
+// write() only moves the record into a lock-free ring (MpmcRingQueue) and
+// never blocks; formatting and I/O happen on the sink's own thread. A full
+// ring drops the record and counts it. The destructor writes what is queued.
+class AsyncLogSink : public LogSink {
+public:
+    explicit AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity = 1024);
+    ~AsyncLogSink() override;
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    void write(const LogRecord& record) override;
+
+    // Block until every record accepted so far has reached the target
+    void flush();
+
+    // get the number of records discarded because the ring was full
+    size_t getDroppedCount() const { return dropped; }
+
+private:
+    // Background thread: pass queued records to the target until stopped
+    void run();
+
+    std::shared_ptr<LogSink> target;
+    MpmcRingQueue<LogRecord> records;
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<size_t> dropped{0};
+
+    // The thread sleeps when the ring is empty; writers only take the mutex to wake it
+    std::atomic<bool> sleeping{false};
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    std::thread thread;
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,146 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SlabAllocator.h"
+#include "TaskFunction.h"
+
+namespace detail {
+
+// Index of the highest set bit, x must not be zero
+inline unsigned highestBit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<unsigned>(__builtin_clzll(x));
+#else
+    unsigned n = 0;
+    while (x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+} // namespace detail
+
+// Counts of one histogram at the time of a snapshot, see LatencyHistogram
+struct HistogramSnapshot {
+    // Per-bucket counts, empty when metrics are compiled out
+    std::vector<uint64_t> buckets;
+    uint64_t count = 0;
+    // Sum of all recorded values in nanoseconds
+    uint64_t sum = 0;
+
+    // Value in nanoseconds below which the fraction p (0..1) of the samples fall, 0 if empty
+    // Exact to within one bucket, i.e. 1/16 of the value
+    uint64_t percentile(double p) const;
+
+    double mean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / count; }
+
+    // Add another histogram's counts to this one
+    void merge(const HistogramSnapshot& other);
+};
+
+// Log-linear (HDR-style) histogram of nanosecond durations.
+//
+// Values are grouped by their highest set bit and every power of two is split
+// into 16 linear sub-buckets, so a bucket is never wider than 1/16 of the
+// values in it while 976 buckets cover the whole uint64_t range. Recording is
+// one relaxed increment; readers see a consistent-enough view without locks.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(uint64_t nanos) {
+        buckets[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(nanos, std::memory_order_relaxed);
+    }
+
+    // Add the current counts to a snapshot
+    void addTo(HistogramSnapshot& snapshot) const;
+
+    static size_t bucketOf(uint64_t nanos) {
+        if (nanos < kSubBuckets) {
+            return static_cast<size_t>(nanos);
+        }
+        unsigned shift = detail::highestBit(nanos) - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<size_t>((nanos >> shift) - kSubBuckets);
+    }
+
+    // Largest value that falls into a bucket
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+    std::atomic<uint64_t> total{0};
+};
+
+// Counters of one worker (or of all non-worker threads together), written by their owner
+struct alignas(64) WorkerCounters {
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> failed{0};
+    // Tasks dropped at dequeue because they were cancelled or past their deadline
+    std::atomic<uint64_t> skipped{0};
+    // Tasks taken from another worker's deque
+    std::atomic<uint64_t> stolen{0};
+    // Times the worker went to sleep for lack of work
+    std::atomic<uint64_t> parked{0};
+#if THREADPOOL_METRICS
+    // From submission to start, and from start to end of a task
+    LatencyHistogram queue_wait;
+    LatencyHistogram execution;
+#endif
+};
+
+// Per-worker view in a MetricsSnapshot
+struct WorkerMetrics {
+    size_t id = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t stolen = 0;
+    uint64_t parked = 0;
+};
+
+// Point-in-time view of a pool's statistics, returned by ThreadPool::snapshot()
+struct MetricsSnapshot {
+    size_t threads = 0;
+    size_t active_threads = 0;
+    size_t pending_tasks = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t skipped = 0;
+    uint64_t rejected = 0;
+    uint64_t dropped = 0;
+    uint64_t caller_runs = 0;
+    uint64_t scale_ups = 0;
+    uint64_t scale_downs = 0;
+    // One entry per worker slot ever used; tasks run by other threads are not listed
+    std::vector<WorkerMetrics> workers;
+    // Over all threads; empty when metrics are compiled out
+    HistogramSnapshot queue_wait;
+    HistogramSnapshot execution;
+    // Slab pool of task frames, closures and shared states; process-wide, shared by all pools
+    SlabStats allocator;
+};
+
+// Render a snapshot in the Prometheus text exposition format
+std::string toPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix = "threadpool");
+
+namespace detail {
+
+// Clock of the task timestamps, steady_clock in nanoseconds
+inline uint64_t metricsNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace detail
+
+#endif // METRICS_H
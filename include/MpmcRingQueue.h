@@ -0,0 +1,115 @@
+#ifndef MPMC_RING_QUEUE_H
+#define MPMC_RING_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Bounded lock-free multi-producer multi-consumer FIFO (Vyukov).
+//
+// Every cell carries a sequence number telling producers and consumers
+// whether it is free for the lap they are on, so a push or pop is a single
+// CAS on the shared position plus one release store on the cell. Cells and
+// both positions sit on their own cache lines. tryPush() fails when the
+// ring is full instead of growing.
+template<class T>
+class MpmcRingQueue {
+public:
+    explicit MpmcRingQueue(size_t capacity = 1024) {
+        size_t cap = 2;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        cells.reset(new Cell[cap]);
+        mask = cap - 1;
+        for (size_t i = 0; i < cap; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingQueue(const MpmcRingQueue&) = delete;
+    MpmcRingQueue& operator=(const MpmcRingQueue&) = delete;
+
+    ~MpmcRingQueue() {
+        T item;
+        while (tryPop(item)) {
+        }
+    }
+
+    // Append an item, leaves it untouched and returns false if the ring is full
+    bool tryPush(T&& item) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(cell->storage)) T(std::move(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Take the oldest item, returns false if the ring is empty
+    bool tryPop(T& item) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* stored = std::launder(reinterpret_cast<T*>(cell->storage));
+        item = std::move(*stored);
+        stored->~T();
+        // Free the cell for the producer one lap ahead
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of items, exact only when no push or pop is in flight
+    size_t size() const {
+        size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        size_t head = dequeue_pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+};
+
+#endif // MPMC_RING_QUEUE_H
@@ -0,0 +1,229 @@
+#ifndef PARALLEL_ALGORITHMS_H
+#define PARALLEL_ALGORITHMS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include "ThreadPool.h"
+
+// Fork-join parallel algorithms built on ThreadPool.
+//
+// Ranges are split recursively in halves down to a grain size. The right
+// half is posted to the pool (onto the worker's local deque when called
+// from a worker, where idle workers steal the largest halves first) and the
+// left half is processed by the calling thread. The overflow policy of a
+// bounded pool does not apply to the right halves; one removed by
+// clearTasks() fails with std::future_errc::broken_promise. While waiting for the other
+// half the caller runs queued pool tasks instead of blocking, so these
+// functions can be nested and also work from inside pool tasks.
+//
+// A grain of 0 picks one automatically from the range size and pool size.
+// The first exception thrown by any chunk is rethrown to the caller.
+// Do not call them on a paused pool: posted halves would never run.
+
+namespace detail {
+
+// Default grain: about eight chunks per thread (workers plus the caller)
+inline size_t autoGrain(const ThreadPool& pool, size_t size, size_t minimum = 1) {
+    size_t chunks = (pool.getThreadCount() + 1) * 8;
+    return std::max(minimum, size / chunks);
+}
+
+// Posts right halves past the overflow policy, like the other continuations of accepted work
+struct ForkJoinAccess {
+    static void fork(ThreadPool& pool, TaskFunction task) { pool.submitUnbounded(std::move(task)); }
+};
+
+// Owns the completion of a posted right half, fails it with broken_promise if destroyed unrun
+class ForkHandle {
+public:
+    ForkHandle(std::atomic<bool>& done, std::exception_ptr& error) : done(&done), error(&error) {}
+    ForkHandle(ForkHandle&& other) noexcept : done(other.done), error(other.error) { other.done = nullptr; }
+    ForkHandle& operator=(ForkHandle&&) = delete;
+
+    ~ForkHandle() {
+        if (done) {
+            *error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            done->store(true, std::memory_order_release);
+        }
+    }
+
+    // Complete after running, with the exception of the half if it threw
+    void finish(std::exception_ptr failure) {
+        *error = std::move(failure);
+        done->store(true, std::memory_order_release);
+        done = nullptr;
+    }
+
+private:
+    std::atomic<bool>* done;
+    std::exception_ptr* error;
+};
+
+// Wait for a flag while helping the pool with queued work
+inline void helpUntil(ThreadPool& pool, const std::atomic<bool>& done) {
+    while (!done.load(std::memory_order_acquire)) {
+        if (!pool.runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace detail
+
+// Run left on the calling thread and right on the pool, return when both finished
+template<class Left, class Right>
+void parallelInvoke(ThreadPool& pool, Left&& left, Right&& right) {
+    std::atomic<bool> rightDone{false};
+    std::exception_ptr rightError;
+
+    detail::ForkJoinAccess::fork(pool, TaskFunction(
+        [&right, handle = detail::ForkHandle(rightDone, rightError)]() mutable {
+            std::exception_ptr failure;
+            try {
+                right();
+            } catch(...) {
+                failure = std::current_exception();
+            }
+            handle.finish(std::move(failure));
+        }));
+
+    std::exception_ptr leftError;
+    try {
+        left();
+    } catch(...) {
+        leftError = std::current_exception();
+    }
+
+    detail::helpUntil(pool, rightDone);
+
+    if (leftError) {
+        std::rethrow_exception(leftError);
+    }
+    if (rightError) {
+        std::rethrow_exception(rightError);
+    }
+}
+
+namespace detail {
+
+// Recursively split [begin, end) and call rangeFn on chunks of at most grain elements
+template<class Index, class RangeFn>
+void splitRange(ThreadPool& pool, Index begin, Index end, size_t grain, const RangeFn& rangeFn) {
+    size_t size = static_cast<size_t>(end - begin);
+    if (size <= grain) {
+        rangeFn(begin, end);
+        return;
+    }
+
+    Index middle = begin + static_cast<decltype(end - begin)>(size / 2);
+    parallelInvoke(pool,
+        [&] { splitRange(pool, begin, middle, grain, rangeFn); },
+        [&] { splitRange(pool, middle, end, grain, rangeFn); });
+}
+
+// Accumulates in T, the type of init, so e.g. ints can be summed into a long long
+template<class T, class RandomIt, class BinaryOp>
+T reduceRange(ThreadPool& pool, RandomIt first, RandomIt last, size_t grain, const BinaryOp& op) {
+    size_t size = static_cast<size_t>(last - first);
+    if (size <= grain) {
+        T acc = static_cast<T>(*first);
+        for (++first; first != last; ++first) {
+            acc = op(std::move(acc), *first);
+        }
+        return acc;
+    }
+
+    RandomIt middle = first + (last - first) / 2;
+    T leftSum{}, rightSum{};
+    parallelInvoke(pool,
+        [&] { leftSum = reduceRange<T>(pool, first, middle, grain, op); },
+        [&] { rightSum = reduceRange<T>(pool, middle, last, grain, op); });
+    return op(std::move(leftSum), std::move(rightSum));
+}
+
+template<class RandomIt, class Compare>
+void sortRange(ThreadPool& pool, RandomIt first, RandomIt last, size_t grain, const Compare& comp) {
+    size_t size = static_cast<size_t>(last - first);
+    if (size <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    RandomIt middle = first + (last - first) / 2;
+    parallelInvoke(pool,
+        [&] { sortRange(pool, first, middle, grain, comp); },
+        [&] { sortRange(pool, middle, last, grain, comp); });
+    std::inplace_merge(first, middle, last, comp);
+}
+
+} // namespace detail
+
+// Call fn(i) for every i in [begin, end), Index may be an integer or a random access iterator
+template<class Index, class F>
+void parallelFor(ThreadPool& pool, Index begin, Index end, size_t grain, F&& fn) {
+    if (!(begin < end)) {
+        return;
+    }
+    size_t size = static_cast<size_t>(end - begin);
+    if (grain == 0) {
+        grain = detail::autoGrain(pool, size);
+    }
+
+    detail::splitRange(pool, begin, end, grain, [&fn](Index first, Index last) {
+        for (; first != last; ++first) {
+            fn(first);
+        }
+    });
+}
+
+template<class Index, class F>
+void parallelFor(ThreadPool& pool, Index begin, Index end, F&& fn) {
+    parallelFor(pool, begin, end, 0, std::forward<F>(fn));
+}
+
+// Reduce [first, last) with an associative op, init is combined once with the total
+template<class RandomIt, class T, class BinaryOp = std::plus<>>
+T parallelReduce(ThreadPool& pool, RandomIt first, RandomIt last, T init,
+                 BinaryOp op = BinaryOp(), size_t grain = 0) {
+    if (first == last) {
+        return init;
+    }
+    size_t size = static_cast<size_t>(last - first);
+    if (grain == 0) {
+        grain = detail::autoGrain(pool, size);
+    }
+    return op(std::move(init), detail::reduceRange<T>(pool, first, last, grain, op));
+}
+
+// Write op(*it) for every element of [first, last) to the range starting at out
+template<class RandomIt, class OutputIt, class UnaryOp>
+OutputIt parallelTransform(ThreadPool& pool, RandomIt first, RandomIt last, OutputIt out,
+                           UnaryOp op, size_t grain = 0) {
+    auto size = last - first;
+    parallelFor(pool, decltype(size){0}, size, grain, [&](decltype(size) i) {
+        out[i] = op(first[i]);
+    });
+    return out + size;
+}
+
+// Sort [first, last): chunks are sorted in parallel, then merged pairwise
+template<class RandomIt, class Compare = std::less<>>
+void parallelSort(ThreadPool& pool, RandomIt first, RandomIt last,
+                  Compare comp = Compare(), size_t grain = 0) {
+    size_t size = static_cast<size_t>(last - first);
+    if (size < 2) {
+        return;
+    }
+    if (grain == 0) {
+        grain = detail::autoGrain(pool, size, 2048);
+    }
+    detail::sortRange(pool, first, last, grain, comp);
+}
+
+#endif // PARALLEL_ALGORITHMS_H
@@ -0,0 +1,203 @@
+#ifndef PARTITIONED_EXECUTOR_H
+#define PARTITIONED_EXECUTOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// Configuration of one partition of a PartitionedExecutor
+struct PartitionOptions {
+    std::string name;
+    // Share of the workers relative to the other partitions while they compete, at least 1
+    unsigned weight = 1;
+    // Workers held back for this partition even while it is idle, so its tasks start right away
+    size_t min_workers = 0;
+    // Most of its tasks running at once, 0 for no limit beyond the executor's
+    size_t max_workers = 0;
+    // Linux only: nice value and SCHED_BATCH policy of a worker while it runs this partition's tasks
+    std::optional<int> nice;
+    bool batch_scheduling = false;
+};
+
+class PartitionedExecutor;
+
+// Named sub-executor with its own queue; created by PartitionedExecutor::addPartition()
+class Partition {
+public:
+    Partition(const Partition&) = delete;
+    Partition& operator=(const Partition&) = delete;
+
+    // Queue a fire-and-forget task; exceptions are counted and reported like ThreadPool::post()
+    template<class F>
+    void post(F&& f);
+
+    // Queue a task, its result and exception go to the future
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    const std::string& getName() const { return options.name; }
+
+    size_t getQueuedTaskCount() const;
+    size_t getRunningTaskCount() const;
+    uint64_t getCompletedTaskCount() const;
+    uint64_t getFailedTaskCount() const;
+
+    // Whether the configured nice value is applied; false if this process may not switch it back
+    bool isNiceApplied() const { return options.nice.has_value(); }
+
+private:
+    friend class PartitionedExecutor;
+
+    Partition(PartitionedExecutor& executor, PartitionOptions options);
+
+    PartitionedExecutor& executor;
+    // nice is cleared if it cannot be applied
+    PartitionOptions options;
+    // Virtual time advance per dispatched task, inversely proportional to the weight
+    const uint64_t stride;
+
+    // Guarded by the executor's mutex
+    std::deque<TaskFunction> queue;
+    size_t running = 0;
+    uint64_t pass = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+};
+
+// Multiplexes named partitions over the workers of one ThreadPool.
+//
+// At most max_workers tasks of all partitions run at once, each on a pool
+// worker. Whenever a worker is free for the executor, the partitions take
+// turns by weighted fair (stride) scheduling: a partition with weight 3 gets
+// three times the dispatches of one with weight 1 while both have work.
+// min_workers are reserved for a partition, the others never use them;
+// max_workers caps a partition, e.g. one doing blocking I/O. The partitions'
+// tasks run inside runner tasks on the pool, up to a batch of them each, so
+// a pool task counts once per runner rather than once per partition task.
+// The pool must outlive the executor.
+class PartitionedExecutor {
+public:
+    // max_workers 0: as many as the pool has threads now
+    explicit PartitionedExecutor(ThreadPool& pool, size_t max_workers = 0);
+
+    PartitionedExecutor(const PartitionedExecutor&) = delete;
+    PartitionedExecutor& operator=(const PartitionedExecutor&) = delete;
+
+    // Waits for the queued and running tasks
+    ~PartitionedExecutor();
+
+    // Throws std::invalid_argument for a zero weight, max_workers below min_workers,
+    // or if the reserved workers would exceed getMaxWorkers()
+    Partition& addPartition(PartitionOptions options);
+
+    // null if there is no partition of that name
+    Partition* getPartition(const std::string& name);
+
+    // Block until every partition is empty and idle, helping with queued pool tasks
+    void wait();
+
+    size_t getMaxWorkers() const { return max_workers; }
+
+    // get the number of partition tasks running right now
+    size_t getRunningTaskCount() const;
+
+private:
+    friend class Partition;
+
+    // Partition tasks a runner runs before it re-posts itself to let other pool work in
+    static constexpr size_t kRunnerBatch = 64;
+
+    // Owns a runner slot on behalf of a queued runner task, gives it back if destroyed unrun
+    struct RunnerHandle {
+        PartitionedExecutor* executor;
+
+        explicit RunnerHandle(PartitionedExecutor* executor) : executor(executor) {}
+        RunnerHandle(RunnerHandle&& other) noexcept : executor(other.executor) { other.executor = nullptr; }
+        RunnerHandle& operator=(RunnerHandle&&) = delete;
+
+        ~RunnerHandle() {
+            if (executor) {
+                executor->runnerLost();
+            }
+        }
+    };
+
+    void submit(Partition& partition, TaskFunction task);
+
+    // Reserved workers the partitions do not use right now, requires mutex
+    size_t unusedReservation() const;
+
+    // Whether partition may start another task now, requires mutex
+    bool dispatchable(const Partition& partition, size_t unused_reservation) const;
+
+    // The partition to run next, its task claimed; null if none may run, requires mutex
+    Partition* pick();
+
+    // Run partition tasks on the calling worker until none may run or the batch is done
+    void runBatch();
+
+    // Post a runner task for a runner slot already counted in runners
+    void postRunner();
+
+    // A runner task was destroyed without running
+    void runnerLost();
+
+    // No runner is left although tasks are queued: start one or, if the pool refuses, drop them
+    // Takes the lock, which must not be held
+    void restartOrDrop();
+
+    // Wake wait() once everything is idle, requires mutex
+    void notifyIfIdle();
+
+    ThreadPool& pool;
+    const size_t max_workers;
+
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::vector<std::unique_ptr<Partition>> partitions;
+    // Runner tasks posted and not finished, never above max_workers
+    size_t runners = 0;
+    // Partition tasks running, and those queued
+    size_t active = 0;
+    size_t queued = 0;
+    // Pass of the last dispatch; a partition that wakes up starts from here, not with saved credit
+    uint64_t virtual_time = 0;
+    // Sum of min_workers over the partitions
+    size_t reserved = 0;
+    // Some partition changes the nice value or scheduling policy of the workers
+    bool uses_thread_settings = false;
+};
+
+template<class F>
+void Partition::post(F&& f) {
+    executor.submit(*this, TaskFunction(std::forward<F>(f)));
+}
+
+template<class F, class... Args>
+auto Partition::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+
+    using return_type = typename std::invoke_result<F, Args...>::type;
+
+    std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+    std::future<return_type> result = promise.get_future();
+    executor.submit(*this, ThreadPool::packageTask(std::move(promise),
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+            return std::apply(fn, bound);
+        }));
+    return result;
+}
+
+#endif // PARTITIONED_EXECUTOR_H
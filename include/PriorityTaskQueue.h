@@ -0,0 +1,285 @@
+#ifndef PRIORITY_TASK_QUEUE_H
+#define PRIORITY_TASK_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "MpmcRingQueue.h"
+#include "RingQueue.h"
+#include "TaskFunction.h"
+#include "ThreadPoolConfig.h"
+
+// Scheduling priority of a submitted task
+enum class TaskPriority {
+    High = 0,
+    Normal = 1,
+    Low = 2
+};
+
+// Bucketed priority queue: one FIFO ring per priority level.
+//
+// pop() serves the highest non-empty level, except that every time a
+// non-empty lower level is passed over its skip count grows; once it
+// reaches the aging limit that level is served next. A low-priority task
+// therefore waits for at most aging_limit higher-priority dequeues per
+// level above it and cannot starve.
+//
+// Not thread-safe, the pool guards it with queue_mutex. The per-level
+// counts can be read concurrently without the lock.
+class PriorityTaskQueue {
+public:
+    static constexpr size_t kLevels = 3;
+    // Callers must serialize access
+    static constexpr bool kLockFree = false;
+
+    void push(TaskFunction&& task, TaskPriority priority) {
+        size_t level = static_cast<size_t>(priority);
+        levels[level].push(std::move(task));
+        counts[level].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool pop(TaskFunction& task) {
+        // Aged levels first, the lowest (longest starving) one wins
+        for (size_t level = kLevels; level-- > 1;) {
+            if (!levels[level].empty() && skipped[level] >= aging_limit) {
+                take(level, task);
+                return true;
+            }
+        }
+
+        for (size_t level = 0; level < kLevels; ++level) {
+            if (levels[level].empty()) {
+                continue;
+            }
+            take(level, task);
+            for (size_t lower = level + 1; lower < kLevels; ++lower) {
+                if (!levels[lower].empty()) {
+                    ++skipped[lower];
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Take the oldest droppable task of one level, used to shed load
+    bool popDroppable(TaskPriority priority, TaskFunction& task) {
+        size_t level = static_cast<size_t>(priority);
+        if (!levels[level].removeFirst([](const TaskFunction& queued) { return queued.isDroppable(); }, task)) {
+            return false;
+        }
+        counts[level].fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Number of higher-priority dequeues after which a waiting level is served
+    void setAgingLimit(size_t limit) {
+        aging_limit = limit == 0 ? 1 : limit;
+    }
+
+    size_t size(TaskPriority priority) const {
+        return counts[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t level = 0; level < kLevels; ++level) {
+            total += counts[level].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Discard every task, returns how many there were
+    size_t clear() {
+        size_t removed = size();
+        for (size_t level = 0; level < kLevels; ++level) {
+            levels[level].clear();
+            counts[level].store(0, std::memory_order_relaxed);
+            skipped[level] = 0;
+        }
+        return removed;
+    }
+
+    // Move every task into removed, so the caller can destroy them outside its lock
+    size_t clear(std::vector<TaskFunction>& removed) {
+        size_t count = 0;
+        for (size_t level = 0; level < kLevels; ++level) {
+            while (!levels[level].empty()) {
+                removed.push_back(levels[level].pop());
+                ++count;
+            }
+            counts[level].store(0, std::memory_order_relaxed);
+            skipped[level] = 0;
+        }
+        return count;
+    }
+
+private:
+    void take(size_t level, TaskFunction& task) {
+        task = levels[level].pop();
+        counts[level].fetch_sub(1, std::memory_order_relaxed);
+        skipped[level] = 0;
+    }
+
+    RingQueue<TaskFunction> levels[kLevels];
+    std::atomic<size_t> counts[kLevels] = {};
+    size_t skipped[kLevels] = {};
+    size_t aging_limit = 16;
+};
+
+// Thread-safe variant of PriorityTaskQueue with the same interface.
+//
+// Each level is a lock-free MPMC ring, so pushes and pops need no lock in
+// the common case. When a ring is full, tasks of that level go to a
+// mutex-guarded spill queue, which is kept in use until it drains so the
+// order stays (approximately) FIFO. Aging works as in PriorityTaskQueue
+// but is only approximate under concurrent pops.
+class LockFreePriorityTaskQueue {
+public:
+    static constexpr size_t kLevels = 3;
+    static constexpr size_t kRingCapacity = 1024;
+    // Safe to use from any thread without external locking
+    static constexpr bool kLockFree = true;
+
+    void push(TaskFunction&& task, TaskPriority priority) {
+        size_t level = static_cast<size_t>(priority);
+        // Counted first so a concurrent pop never drives the count below zero
+        counts[level].fetch_add(1, std::memory_order_relaxed);
+        if (spilled[level].load(std::memory_order_acquire) == 0 && rings[level].tryPush(std::move(task))) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(spill_mutex);
+        spill[level].push(std::move(task));
+        spilled[level].fetch_add(1, std::memory_order_release);
+    }
+
+    bool pop(TaskFunction& task) {
+        size_t limit = aging_limit.load(std::memory_order_relaxed);
+        for (size_t level = kLevels; level-- > 1;) {
+            if (size(static_cast<TaskPriority>(level)) > 0 &&
+                skipped[level].load(std::memory_order_relaxed) >= limit && take(level, task)) {
+                return true;
+            }
+        }
+
+        for (size_t level = 0; level < kLevels; ++level) {
+            if (size(static_cast<TaskPriority>(level)) == 0 || !take(level, task)) {
+                continue;
+            }
+            for (size_t lower = level + 1; lower < kLevels; ++lower) {
+                if (size(static_cast<TaskPriority>(lower)) > 0) {
+                    skipped[lower].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Take the oldest droppable task of one level, used to shed load
+    // Tasks passed over go back to the end of their level, rings cannot be edited in place
+    bool popDroppable(TaskPriority priority, TaskFunction& task) {
+        size_t level = static_cast<size_t>(priority);
+        for (size_t passes = size(priority); passes > 0 && take(level, task); --passes) {
+            if (task.isDroppable()) {
+                return true;
+            }
+            push(std::move(task), priority);
+        }
+        return false;
+    }
+
+    // Number of higher-priority dequeues after which a waiting level is served
+    void setAgingLimit(size_t limit) {
+        aging_limit.store(limit == 0 ? 1 : limit, std::memory_order_relaxed);
+    }
+
+    size_t size(TaskPriority priority) const {
+        // May transiently read as "negative" between a pop and the matching push count
+        size_t count = counts[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+        return static_cast<ptrdiff_t>(count) < 0 ? 0 : count;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t level = 0; level < kLevels; ++level) {
+            total += size(static_cast<TaskPriority>(level));
+        }
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Discard every task, returns how many there were
+    size_t clear() {
+        size_t removed = 0;
+        TaskFunction task;
+        for (size_t level = 0; level < kLevels; ++level) {
+            while (take(level, task)) {
+                ++removed;
+            }
+            skipped[level].store(0, std::memory_order_relaxed);
+        }
+        return removed;
+    }
+
+    // Move every task into removed, so the caller can destroy them outside its lock
+    size_t clear(std::vector<TaskFunction>& removed) {
+        size_t count = 0;
+        TaskFunction task;
+        for (size_t level = 0; level < kLevels; ++level) {
+            while (take(level, task)) {
+                removed.push_back(std::move(task));
+                ++count;
+            }
+            skipped[level].store(0, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+private:
+    // Pop from one level: the ring first, then the older spilled tasks
+    bool take(size_t level, TaskFunction& task) {
+        if (!rings[level].tryPop(task)) {
+            if (spilled[level].load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(spill_mutex);
+            if (spill[level].empty()) {
+                return false;
+            }
+            task = spill[level].pop();
+            spilled[level].fetch_sub(1, std::memory_order_release);
+        }
+        counts[level].fetch_sub(1, std::memory_order_relaxed);
+        skipped[level].store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    MpmcRingQueue<TaskFunction> rings[kLevels] = {
+        MpmcRingQueue<TaskFunction>(kRingCapacity),
+        MpmcRingQueue<TaskFunction>(kRingCapacity),
+        MpmcRingQueue<TaskFunction>(kRingCapacity)};
+    std::atomic<size_t> counts[kLevels] = {};
+    std::atomic<size_t> skipped[kLevels] = {};
+    std::atomic<size_t> aging_limit{16};
+
+    // Overflow for full rings, guarded by spill_mutex
+    std::mutex spill_mutex;
+    RingQueue<TaskFunction> spill[kLevels];
+    std::atomic<size_t> spilled[kLevels] = {};
+};
+
+// Injection queue backend of ThreadPool, picked at compile time
+// (CMake option THREADPOOL_QUEUE_BACKEND, recorded in ThreadPoolConfig.h)
+#ifdef THREADPOOL_LOCKFREE_QUEUE
+using InjectionQueue = LockFreePriorityTaskQueue;
+#else
+using InjectionQueue = PriorityTaskQueue;
+#endif
+
+#endif // PRIORITY_TASK_QUEUE_H
@@ -0,0 +1,93 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Growable FIFO circular buffer, not thread-safe.
+//
+// Unlike std::queue (backed by std::deque) it never allocates once it has
+// reached its high-water mark, which keeps the injection queue
+// allocation-free in steady state. T must be default constructible and
+// move assignable.
+template<class T>
+class RingQueue {
+public:
+    explicit RingQueue(size_t capacity = 64) {
+        size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        slots.reset(new T[cap]);
+        mask = cap - 1;
+    }
+
+    void push(T&& item) {
+        if (count == mask + 1) {
+            grow();
+        }
+        slots[(head + count) & mask] = std::move(item);
+        ++count;
+    }
+
+    T& front() {
+        return slots[head];
+    }
+
+    // Remove the front element, moving it out
+    T pop() {
+        T item = std::move(slots[head]);
+        head = (head + 1) & mask;
+        --count;
+        return item;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return mask + 1; }
+
+    // Move out the first element matching pred, the ones before it keep their order
+    template<class Pred>
+    bool removeFirst(Pred pred, T& item) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!pred(slots[(head + i) & mask])) {
+                continue;
+            }
+            item = std::move(slots[(head + i) & mask]);
+            for (; i > 0; --i) {
+                slots[(head + i) & mask] = std::move(slots[(head + i - 1) & mask]);
+            }
+            head = (head + 1) & mask;
+            --count;
+            return true;
+        }
+        return false;
+    }
+
+    // Drop all elements, keeping the allocated storage
+    void clear() {
+        while (count > 0) {
+            pop();
+        }
+    }
+
+private:
+    void grow() {
+        size_t cap = (mask + 1) * 2;
+        std::unique_ptr<T[]> bigger(new T[cap]);
+        for (size_t i = 0; i < count; ++i) {
+            bigger[i] = std::move(slots[(head + i) & mask]);
+        }
+        slots = std::move(bigger);
+        head = 0;
+        mask = cap - 1;
+    }
+
+    std::unique_ptr<T[]> slots;
+    size_t mask = 0;
+    size_t head = 0;
+    size_t count = 0;
+};
+
+#endif // RING_QUEUE_H
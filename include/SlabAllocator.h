@@ -0,0 +1,160 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+// Allocation statistics of the slab pool, summed over all threads
+struct SlabStats {
+    // Allocations served from slab memory without reaching the global heap
+    uint64_t hits = 0;
+    // Allocations that did reach it: to carve a new chunk, or for an oversize block
+    uint64_t misses = 0;
+    // Blocks freed by a thread other than the one whose heap they came from
+    uint64_t remote_frees = 0;
+    // Bytes handed out and not freed yet, in whole blocks
+    size_t bytes_in_use = 0;
+    // Bytes taken from the global heap: slab chunks plus live oversize blocks
+    size_t bytes_reserved = 0;
+    size_t peak_bytes_reserved = 0;
+    size_t chunks = 0;
+};
+
+// Process-wide slab pool for small fixed-size blocks.
+//
+// Blocks are grouped in power-of-two size classes. Every thread allocates
+// from its own heap without locking; a block freed by the thread that owns it
+// goes straight back onto that heap's free list, a block freed elsewhere (the
+// usual case for tasks: submitted on a producer, destroyed on a worker) is
+// pushed lock-free onto its heap's remote-free list, which the owner takes
+// over in one exchange once its local list runs dry. Heaps of exited threads
+// are adopted by new ones. Requests larger than kMaxBlockSize are forwarded
+// to operator new. Chunks are never returned and the pool is never destroyed
+// because promise shared states can outlive any ThreadPool.
+class SlabPool {
+public:
+    static constexpr size_t kMinBlockSize = 32;
+    static constexpr size_t kMaxBlockSize = 512;
+    // Chunks are aligned to their size, so a block finds its chunk header by masking its address
+    static constexpr size_t kChunkSize = 16384;
+
+    static SlabPool& instance();
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size) noexcept;
+
+    SlabStats stats() const;
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+private:
+    SlabPool() = default;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t kClassCount = 5; // 32, 64, 128, 256, 512
+
+    struct Heap {
+        // Owner only: recycled blocks, and the uncarved rest of the newest chunk
+        FreeBlock* free_list[kClassCount] = {};
+        char* carve[kClassCount] = {};
+        char* carve_end[kClassCount] = {};
+        // Written by the owner only
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> remote_frees{0};
+        std::atomic<uint64_t> allocated_bytes{0};
+        std::atomic<uint64_t> freed_bytes{0};
+        // Blocks of this heap freed by other threads, pushed by anyone, taken whole by the owner
+        alignas(64) std::atomic<FreeBlock*> remote_free[kClassCount] = {};
+        // Registry links, guarded by heaps_mutex
+        Heap* next_heap = nullptr;
+        Heap* next_orphan = nullptr;
+    };
+
+    // Start of every chunk, padded so the blocks after it stay aligned
+    struct alignas(64) ChunkHeader {
+        Heap* heap;
+    };
+
+    // Gives the thread's heap back for adoption when the thread exits
+    struct HeapRelease {
+        ~HeapRelease();
+    };
+
+    static size_t classIndex(size_t size);
+
+    // Heap of the calling thread, null once the thread is past its thread_local teardown
+    Heap* threadHeap();
+
+    Heap* adoptHeap();
+    void releaseHeap(Heap* heap);
+
+    void* allocateFrom(Heap& heap, size_t index);
+
+    // Give a heap a fresh chunk for a size class
+    void addChunk(Heap& heap, size_t index);
+
+    // Account for memory taken from the global heap, keeping the peak
+    void reserve(size_t bytes);
+
+    static thread_local Heap* current_heap;
+    static thread_local bool heap_released;
+
+    // Every heap ever created, and the ones whose thread has exited
+    mutable std::mutex heaps_mutex;
+    Heap* heaps = nullptr;
+    Heap* orphans = nullptr;
+
+    // Serves threads that allocate during their thread_local teardown
+    std::mutex shared_mutex;
+    Heap shared_heap;
+
+    std::atomic<size_t> chunk_count{0};
+    std::atomic<size_t> reserved_bytes{0};
+    std::atomic<size_t> peak_reserved_bytes{0};
+    std::atomic<size_t> oversize_bytes{0};
+    std::atomic<uint64_t> oversize_allocations{0};
+    // Frees by threads without a heap of their own
+    std::atomic<uint64_t> unowned_remote_frees{0};
+    std::atomic<uint64_t> unowned_freed_bytes{0};
+};
+
+// Standard allocator adapter over SlabPool, e.g. for std::promise shared states
+template<class T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    SlabAllocator() noexcept = default;
+    template<class U>
+    SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (alignof(T) > alignof(std::max_align_t)) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(SlabPool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (alignof(T) > alignof(std::max_align_t)) {
+            ::operator delete(p);
+            return;
+        }
+        SlabPool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    template<class U>
+    bool operator==(const SlabAllocator<U>&) const noexcept { return true; }
+    template<class U>
+    bool operator!=(const SlabAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // SLAB_ALLOCATOR_H
@@ -0,0 +1,266 @@
+#ifndef STRAND_H
+#define STRAND_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// Serial executor on top of a ThreadPool: tasks posted to one strand run in
+// submission order and never at the same time, without a thread of their own.
+//
+// Posting is lock-free: tasks go into an intrusive MPSC queue and the poster
+// that finds the strand idle schedules one drain task on the pool. The drain
+// runs up to batch_limit queued tasks back-to-back on its worker, then
+// re-posts itself (to that worker's local deque) if more are waiting, so
+// other pool work gets a turn. A strand holds at most one pool task at a time,
+// which is exempt from the overflow policy of a bounded pool; the tasks inside
+// it are not counted as pool tasks. If that drain task is discarded unrun
+// (clearTasks(), DropOldest, destruction) the tasks queued on the strand are
+// discarded with it.
+class Strand {
+public:
+    static constexpr size_t kDefaultBatch = 64;
+
+    explicit Strand(ThreadPool& pool, size_t batch_limit = kDefaultBatch)
+        : state(std::make_shared<State>(pool, batch_limit)) {}
+
+    // Queue a fire-and-forget task; exceptions are counted and reported like ThreadPool::post()
+    template<class F>
+    void post(F&& f);
+
+    // Queue a task, its result and exception go to the future
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // Whether the calling thread is running a task of this strand right now
+    bool runningInThisThread() const { return current_strand() == state.get(); }
+
+    // get the number of tasks queued on or running in the strand
+    size_t getTaskCount() const { return state->pending; }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        TaskFunction task;
+    };
+
+    struct State {
+        State(ThreadPool& pool, size_t batch_limit)
+            : pool(pool), batch_limit(batch_limit ? batch_limit : 1), head(newNode()), tail(head) {}
+
+        ~State() {
+            while (head) {
+                Node* next = head->next.load(std::memory_order_relaxed);
+                deleteNode(head);
+                head = next;
+            }
+        }
+
+        // Producer side, any thread: append a task, schedules a drain if the strand was idle
+        void push(TaskFunction task, const std::shared_ptr<State>& self);
+
+        // Consumer side, only the drain: take the oldest task, false while a push is half done
+        bool pop(TaskFunction& task);
+
+        // Run a batch of tasks on the calling worker
+        void drain(const std::shared_ptr<State>& self);
+
+        // Post the drain task to the pool
+        void schedule(const std::shared_ptr<State>& self);
+
+        // The drain task was destroyed without running: drop what it would have run
+        void abandon(const std::shared_ptr<State>& self);
+
+        static Node* newNode() {
+            Node* node = SlabAllocator<Node>().allocate(1);
+            return ::new (static_cast<void*>(node)) Node();
+        }
+
+        static void deleteNode(Node* node) {
+            node->~Node();
+            SlabAllocator<Node>().deallocate(node, 1);
+        }
+
+        ThreadPool& pool;
+        const size_t batch_limit;
+        // Tasks pushed and not yet run or dropped; the 0 -> 1 transition schedules a drain
+        std::atomic<size_t> pending{0};
+        // Consumer end (a node whose task was already taken) and producer end of the queue
+        Node* head;
+        alignas(64) std::atomic<Node*> tail;
+    };
+
+    // Owns the state on behalf of a queued drain task, abandons the strand if destroyed unrun
+    struct DrainHandle {
+        std::shared_ptr<State> state;
+
+        explicit DrainHandle(std::shared_ptr<State> state) : state(std::move(state)) {}
+        DrainHandle(DrainHandle&& other) noexcept = default;
+        DrainHandle& operator=(DrainHandle&&) = delete;
+
+        ~DrainHandle() {
+            if (state) {
+                state->abandon(state);
+            }
+        }
+    };
+
+    // Strand being drained on this thread, null outside of a drain
+    static State*& current_strand() {
+        static thread_local State* strand = nullptr;
+        return strand;
+    }
+
+    std::shared_ptr<State> state;
+};
+
+// Runs tasks with equal keys serially and in order, tasks with other keys in parallel.
+//
+// Keys are hashed onto a fixed set of strands, so memory does not grow with
+// the number of keys; two keys that share a strand are serialized with each
+// other as well. Choose stripes well above the expected concurrency.
+template<class Key, class Hash = std::hash<Key>>
+class KeyedExecutor {
+public:
+    explicit KeyedExecutor(ThreadPool& pool, size_t stripes = 64, size_t batch_limit = Strand::kDefaultBatch) {
+        strands.reserve(stripes ? stripes : 1);
+        for (size_t i = 0; i < strands.capacity(); ++i) {
+            strands.emplace_back(pool, batch_limit);
+        }
+    }
+
+    template<class F>
+    void post(const Key& key, F&& f) {
+        strandFor(key).post(std::forward<F>(f));
+    }
+
+    template<class F, class... Args>
+    auto enqueue(const Key& key, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type> {
+        return strandFor(key).enqueue(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // The strand tasks of key run on
+    Strand& strandFor(const Key& key) {
+        // Spread weak hashes such as the identity hash of integers over the stripes
+        uint64_t h = static_cast<uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ULL;
+        return strands[static_cast<size_t>((h >> 32) % strands.size())];
+    }
+
+private:
+    std::vector<Strand> strands;
+    Hash hash;
+};
+
+template<class F>
+void Strand::post(F&& f) {
+    state->push(TaskFunction(std::forward<F>(f)), state);
+}
+
+template<class F, class... Args>
+auto Strand::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+
+    using return_type = typename std::invoke_result<F, Args...>::type;
+
+    std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+    std::future<return_type> result = promise.get_future();
+    state->push(ThreadPool::packageTask(std::move(promise),
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+            return std::apply(fn, bound);
+        }), state);
+    return result;
+}
+
+inline void Strand::State::push(TaskFunction task, const std::shared_ptr<State>& self) {
+    Node* node = newNode();
+    node->task = std::move(task);
+    // Publish the node: claim the tail, then link it behind the previous one
+    Node* previous = tail.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+
+    if (pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+        schedule(self);
+    }
+}
+
+inline bool Strand::State::pop(TaskFunction& task) {
+    Node* next = head->next.load(std::memory_order_acquire);
+    if (!next) {
+        return false;
+    }
+    task = std::move(next->task);
+    deleteNode(head);
+    head = next;
+    return true;
+}
+
+inline void Strand::State::drain(const std::shared_ptr<State>& self) {
+    State*& current = current_strand();
+    State* outer = current;
+    current = this;
+
+    size_t ran = 0;
+    size_t available = pending.load(std::memory_order_acquire);
+    while (ran < available && ran < batch_limit) {
+        TaskFunction task;
+        // Counted but not linked yet: the producer is between its two steps
+        while (!pop(task)) {
+            std::this_thread::yield();
+        }
+        try {
+            task();
+        } catch(...) {
+            pool.reportTaskError(std::current_exception());
+        }
+        ++ran;
+        if (ran == available) {
+            available = pending.load(std::memory_order_acquire);
+        }
+    }
+    current = outer;
+
+    // Whoever takes pending to zero leaves the strand idle, otherwise keep going
+    if (pending.fetch_sub(ran, std::memory_order_acq_rel) != ran) {
+        schedule(self);
+    }
+}
+
+inline void Strand::State::schedule(const std::shared_ptr<State>& self) {
+    pool.submitUnbounded(TaskFunction([handle = DrainHandle(self)]() mutable {
+        std::shared_ptr<State> state = std::move(handle.state);
+        state->drain(state);
+    }));
+}
+
+inline void Strand::State::abandon(const std::shared_ptr<State>& self) {
+    size_t dropped = 0;
+    size_t available = pending.load(std::memory_order_acquire);
+    TaskFunction task;
+    while (dropped < available) {
+        while (!pop(task)) {
+            std::this_thread::yield();
+        }
+        task = TaskFunction();
+        ++dropped;
+    }
+    // Tasks posted meanwhile get a new drain, unless the pool no longer takes any
+    if (pending.fetch_sub(dropped, std::memory_order_acq_rel) != dropped) {
+        try {
+            schedule(self);
+        } catch(...) {
+        }
+    }
+}
+
+#endif // STRAND_H
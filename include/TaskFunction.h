@@ -0,0 +1,179 @@
+#ifndef TASK_FUNCTION_H
+#define TASK_FUNCTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "SlabAllocator.h"
+#include "ThreadPoolConfig.h"
+
+// Move-only, type-erased void() callable with inline small-buffer storage.
+//
+// Replaces std::function<void()> in the task queues: callables that fit in
+// kInlineSize bytes (and are nothrow movable) are stored inside the object
+// itself, so submitting a small lambda does not touch the heap. Larger
+// callables go to the slab pool (the global heap only past
+// SlabPool::kMaxBlockSize). With metrics compiled in, 8 bytes
+// of the buffer hold the submission timestamp instead.
+class TaskFunction {
+public:
+    // Inline buffer size, chosen so that a TaskFunction fills one cache line:
+    // 48 bytes on 64-bit targets with metrics compiled in, 56 without
+    static constexpr size_t kInlineSize = 64 - sizeof(void*) - (THREADPOOL_METRICS ? sizeof(uint64_t) : 0);
+    static constexpr size_t kInlineAlign = alignof(std::max_align_t);
+
+    TaskFunction() noexcept = default;
+
+    template<class F, class = std::enable_if_t<
+        !std::is_same<std::decay_t<F>, TaskFunction>::value>>
+    TaskFunction(F&& f) {
+        using Fn = std::decay_t<F>;
+        if constexpr (fitsInline<Fn>()) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+            ops = &InlineOps<Fn>::table;
+        } else {
+            SlabAllocator<Fn> allocator;
+            Fn* fn = allocator.allocate(1);
+            try {
+                ::new (static_cast<void*>(fn)) Fn(std::forward<F>(f));
+            } catch(...) {
+                allocator.deallocate(fn, 1);
+                throw;
+            }
+            *reinterpret_cast<Fn**>(storage) = fn;
+            ops = &HeapOps<Fn>::table;
+        }
+    }
+
+    TaskFunction(TaskFunction&& other) noexcept {
+        moveFrom(other);
+    }
+
+    TaskFunction& operator=(TaskFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+
+    ~TaskFunction() {
+        reset();
+    }
+
+    // Invoke the stored callable
+    void operator()() {
+        ops->invoke(storage);
+    }
+
+    explicit operator bool() const noexcept {
+        return ops != nullptr;
+    }
+
+    // Whether the callable lives in the inline buffer (no separate allocation)
+    bool isInline() const noexcept {
+        return ops != nullptr && ops->is_inline;
+    }
+
+    // Whether a bounded pool's DropOldest policy may discard this task
+    bool isDroppable() const noexcept {
+        return ops == nullptr || ops->undroppable != nullptr;
+    }
+
+    // Keep the overflow policy from discarding this task, it continues already accepted work
+    void markUndroppable() noexcept {
+        if (ops && ops->undroppable) {
+            ops = ops->undroppable;
+        }
+    }
+
+#if THREADPOOL_METRICS
+    // Submission time in steady_clock nanoseconds, 0 if never stamped; moves with the callable
+    void stamp(uint64_t nanos) noexcept { submit_time = nanos; }
+    uint64_t submitTime() const noexcept { return submit_time; }
+#endif
+
+    // Whether a callable of type F would be stored without a heap allocation
+    template<class F>
+    static constexpr bool fitsInline() {
+        return sizeof(F) <= kInlineSize &&
+               alignof(F) <= kInlineAlign &&
+               std::is_nothrow_move_constructible<F>::value;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* dst, void* src) noexcept;
+        void (*destroy)(void* storage) noexcept;
+        bool is_inline;
+        // The same operations marked as not droppable, null if these already are
+        const Ops* undroppable;
+    };
+
+    template<class Fn, bool Droppable = true>
+    struct InlineOps {
+        static void invoke(void* s) {
+            (*static_cast<Fn*>(s))();
+        }
+        static void relocate(void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        }
+        static void destroy(void* s) noexcept {
+            static_cast<Fn*>(s)->~Fn();
+        }
+        static constexpr Ops table{&invoke, &relocate, &destroy, true,
+                                   Droppable ? &InlineOps<Fn, false>::table : nullptr};
+    };
+
+    template<class Fn, bool Droppable = true>
+    struct HeapOps {
+        static void invoke(void* s) {
+            (**static_cast<Fn**>(s))();
+        }
+        static void relocate(void* dst, void* src) noexcept {
+            *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+        }
+        static void destroy(void* s) noexcept {
+            Fn* fn = *static_cast<Fn**>(s);
+            fn->~Fn();
+            SlabAllocator<Fn>().deallocate(fn, 1);
+        }
+        static constexpr Ops table{&invoke, &relocate, &destroy, false,
+                                   Droppable ? &HeapOps<Fn, false>::table : nullptr};
+    };
+
+    void moveFrom(TaskFunction& other) noexcept {
+#if THREADPOOL_METRICS
+        submit_time = other.submit_time;
+#endif
+        if (other.ops) {
+            other.ops->relocate(storage, other.storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    alignas(kInlineAlign) unsigned char storage[kInlineSize];
+#if THREADPOOL_METRICS
+    uint64_t submit_time = 0;
+#endif
+    const Ops* ops = nullptr;
+};
+
+static_assert(sizeof(TaskFunction) == 64, "TaskFunction should fill exactly one cache line");
+
+#endif // TASK_FUNCTION_H
@@ -0,0 +1,125 @@
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+// Reusable task dependency graph executed on a ThreadPool.
+//
+// Nodes are dispatched to the pool only once all their predecessors have
+// finished; each node carries an atomic counter of unfinished predecessors,
+// so no pool thread ever blocks waiting for another node. A finishing node
+// runs one ready successor inline and posts the others.
+//
+// A built graph can be run any number of times, one run at a time. The
+// graph must stay alive until the future returned by run() is ready. If a
+// node throws, the remaining nodes are skipped and the first exception is
+// stored in the future. Nodes are never refused by a bounded pool; if the
+// pool drops one anyway (it is stopped, or clearTasks() removes the node),
+// the rest of the run is skipped and the future fails with
+// std::future_errc::broken_promise.
+class TaskGraph {
+    struct NodeData;
+
+public:
+    // Lightweight handle to a node of the graph
+    class Node {
+    public:
+        Node() = default;
+
+        // This node runs before other
+        Node& precede(Node other);
+
+        // This node runs after other
+        Node& succeed(Node other);
+
+    private:
+        friend class TaskGraph;
+        Node(TaskGraph* graph, NodeData* data) : graph(graph), data(data) {}
+
+        TaskGraph* graph = nullptr;
+        NodeData* data = nullptr;
+    };
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // Add a node running f
+    template<class F>
+    Node emplace(F&& f) {
+        nodes.emplace_back(std::function<void()>(std::forward<F>(f)));
+        validated = false;
+        return Node(this, &nodes.back());
+    }
+
+    // Run the whole graph on the pool, throws std::logic_error on cycles or concurrent runs
+    std::future<void> run(ThreadPool& pool);
+
+    // get the number of nodes
+    size_t size() const { return nodes.size(); }
+
+private:
+    struct NodeData {
+        explicit NodeData(std::function<void()> work) : work(std::move(work)) {}
+
+        std::function<void()> work;
+        std::vector<NodeData*> successors;
+        size_t predecessors = 0;
+        std::atomic<size_t> remaining{0};
+    };
+
+    void addEdge(NodeData* from, NodeData* to);
+
+    // Throw if the graph contains a cycle
+    void validate();
+
+    // Run a node and then, inline, one of the successors it made ready
+    void execute(NodeData* node);
+
+    // Owns a queued node on behalf of its task, settles it if the task is destroyed unrun
+    struct NodeHandle {
+        TaskGraph* graph;
+        NodeData* node;
+
+        NodeHandle(TaskGraph* graph, NodeData* node) : graph(graph), node(node) {}
+        NodeHandle(NodeHandle&& other) noexcept : graph(other.graph), node(other.node) { other.graph = nullptr; }
+        NodeHandle& operator=(NodeHandle&&) = delete;
+
+        ~NodeHandle() {
+            if (graph) {
+                graph->nodeLost(node);
+            }
+        }
+    };
+
+    // Queue execute(node) on the pool, bypassing the overflow policy
+    // A node the pool refuses is settled by nodeLost() before this returns
+    void post(NodeData* node);
+
+    // A queued node was dropped: fail the run and count the node and its subtree down
+    void nodeLost(NodeData* node);
+
+    // Record the first failure, the remaining nodes are only counted down
+    void fail(std::exception_ptr failure);
+
+    // Stable addresses: nodes are never moved once added
+    std::deque<NodeData> nodes;
+    bool validated = false;
+
+    // State of the current run
+    ThreadPool* pool = nullptr;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> remaining_nodes{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::promise<void> completion;
+};
+
+#endif // TASK_GRAPH_H
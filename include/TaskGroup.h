@@ -0,0 +1,178 @@
+#ifndef TASK_GROUP_H
+#define TASK_GROUP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "ThreadPool.h"
+
+// Scoped completion group: wait for the tasks submitted through it only.
+//
+// Unlike ThreadPool::waitForCompletion() this ignores unrelated work in the
+// pool. wait() runs queued pool tasks while the group is busy, so it can be
+// called from inside a worker, even on a single-threaded pool. Exceptions
+// from run() tasks are counted as failed tasks and the first one is
+// rethrown by wait(). A run() task that is dropped without running (e.g. by
+// clearTasks()) still finishes, and wait() then throws
+// std::future_errc::broken_promise. The destructor waits but discards
+// these exceptions.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool), state(std::make_shared<State>()) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        try {
+            wait();
+        } catch(...) {
+            // Only wait() reports errors
+        }
+    }
+
+    // Submit a fire-and-forget task belonging to this group
+    template<class F>
+    void run(F&& f);
+
+    // Submit a task belonging to this group, its result and exception go to the future
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // Block until every task of the group has finished
+    // Rethrows the first run() error, or throws broken_promise if run() tasks were dropped
+    void wait();
+
+    // get the number of tasks of the group that have not finished
+    size_t getTaskCount() const { return state->pending; }
+
+private:
+    // Shared with the tasks, which may still touch it after wait() returned
+    struct State {
+        std::atomic<size_t> pending{0};
+        std::atomic<size_t> waiters{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        // run() tasks destroyed without running
+        std::atomic<size_t> dropped{0};
+
+        // Called once per task, wakes a waiter only for the last one
+        void finish() {
+            if (pending.fetch_sub(1) == 1 && waiters > 0) {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.notify_all();
+            }
+        }
+    };
+
+    // Calls finish() when the task body is left, however that happens
+    struct FinishGuard {
+        std::shared_ptr<State> state;
+        ~FinishGuard() { state->finish(); }
+    };
+
+    // Owns a task's place in pending on behalf of its closure
+    // If the closure is destroyed unrun the task still finishes, counted as dropped for run() tasks
+    class TaskHandle {
+    public:
+        TaskHandle(std::shared_ptr<State> state, bool counts_drop)
+            : state(std::move(state)), counts_drop(counts_drop) {}
+        TaskHandle(TaskHandle&&) noexcept = default;
+        TaskHandle& operator=(TaskHandle&&) = delete;
+
+        ~TaskHandle() {
+            if (state) {
+                if (counts_drop) {
+                    ++state->dropped;
+                }
+                state->finish();
+            }
+        }
+
+        // The body runs: finishing is up to the returned guard
+        FinishGuard start() { return FinishGuard{std::move(state)}; }
+
+    private:
+        std::shared_ptr<State> state;
+        bool counts_drop;
+    };
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state;
+};
+
+template<class F>
+void TaskGroup::run(F&& f) {
+    // One count for the task, one held until a refusal is accounted for so no waiter sees it as a drop
+    state->pending += 2;
+    try {
+        pool.post([&pool = pool, handle = TaskHandle(state, true), fn = std::forward<F>(f)]() mutable {
+            FinishGuard guard = handle.start();
+            try {
+                fn();
+            } catch(...) {
+                pool.markTaskFailed();
+                if (!guard.state->failed.exchange(true)) {
+                    guard.state->error = std::current_exception();
+                }
+            }
+        });
+    } catch(...) {
+        // The refused task's handle finished it, the caller gets the error instead
+        --state->dropped;
+        state->finish();
+        throw;
+    }
+    state->finish();
+}
+
+template<class F, class... Args>
+auto TaskGroup::enqueue(F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+
+    using return_type = typename std::invoke_result<F, Args...>::type;
+
+    // A dropped task breaks the future's promise, the handle only finishes it
+    ++state->pending;
+    return pool.enqueue([handle = TaskHandle(state, false),
+                         fn = std::forward<F>(f),
+                         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+        FinishGuard guard = handle.start();
+        return std::apply(fn, bound);
+    });
+}
+
+inline void TaskGroup::wait() {
+    // Help with queued work first, our tasks may be sitting behind it
+    while (state->pending > 0 && pool.runPendingTask()) {
+    }
+
+    if (state->pending > 0) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        // Registered before the predicate is checked, finish() reads it after decrementing
+        ++state->waiters;
+        state->done.wait(lock, [this] { return state->pending == 0; });
+        --state->waiters;
+    }
+
+    size_t dropped = state->dropped.exchange(0);
+    if (state->failed) {
+        std::exception_ptr error = std::move(state->error);
+        state->failed = false;
+        std::rethrow_exception(error);
+    }
+    if (dropped > 0) {
+        throw std::future_error(std::future_errc::broken_promise);
+    }
+}
+
+#endif // TASK_GROUP_H
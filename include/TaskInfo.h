@@ -0,0 +1,53 @@
+#ifndef TASK_INFO_H
+#define TASK_INFO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// How a task ended
+enum class TaskOutcome : uint8_t {
+    Completed,
+    // Threw, or captured an exception into its future that counts as a failure
+    Failed,
+    // Not run: cancelled or past its deadline when dequeued
+    Skipped
+};
+
+// What is known about one run of a task, as recorded by the pool's tracer
+struct TaskInfo {
+    // Worker value of tasks run by threads outside the pool (helpers, CallerRuns submitters)
+    static constexpr size_t kExternalWorker = static_cast<size_t>(-1);
+
+    // Unique within a pool, assigned when the task is traced (0 otherwise)
+    uint64_t id = 0;
+    // Tag given with tagged(), null for untagged tasks
+    const char* name = nullptr;
+    // steady_clock nanoseconds, 0 when not measured: submit_time with metrics compiled out or
+    // for tasks run inline, all three for untraced tasks with metrics compiled out
+    uint64_t submit_time = 0;
+    uint64_t start_time = 0;
+    uint64_t end_time = 0;
+    // Worker ID that ran the task, or kExternalWorker
+    size_t worker = kExternalWorker;
+    TaskOutcome outcome = TaskOutcome::Completed;
+};
+
+namespace detail {
+
+// Tag of the task running on this thread, set by tagged() and read back by the pool
+inline thread_local const char* current_task_name = nullptr;
+
+} // namespace detail
+
+// Wrap a callable so that the task running it is traced under name
+// name must outlive the trace (e.g. a string literal); arguments are passed through
+template<class F>
+auto tagged(const char* name, F&& f) {
+    return [name, fn = std::forward<F>(f)](auto&&... args) mutable -> decltype(auto) {
+        detail::current_task_name = name;
+        return fn(std::forward<decltype(args)>(args)...);
+    };
+}
+
+#endif // TASK_INFO_H
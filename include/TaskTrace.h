@@ -0,0 +1,67 @@
+#ifndef TASK_TRACE_H
+#define TASK_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TaskInfo.h"
+
+// Per-task tracing settings of a ThreadPool, off while capacity is 0
+struct TraceOptions {
+    // Records buffered per worker until collectTrace(), rounded up to a power of two
+    size_t capacity = 0;
+    // Record one task in this many on each thread
+    uint32_t sample_every = 1;
+
+    bool enabled() const { return capacity > 0; }
+};
+
+// Fixed-size single-producer single-consumer ring of TaskInfo records.
+//
+// The owning worker pushes without locks; one collector at a time drains it.
+// A full ring drops new records rather than overwriting ones the collector
+// may be reading, and counts them.
+class TraceRing {
+public:
+    explicit TraceRing(size_t capacity);
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    // Producer side: append a record, returns false (and counts a drop) if full
+    bool push(const TaskInfo& info) {
+        uint64_t head = write_index.load(std::memory_order_relaxed);
+        if (head - read_index.load(std::memory_order_acquire) > mask) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        records[head & mask] = info;
+        write_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: next record ID of this ring
+    uint64_t nextSequence() { return ++sequence; }
+
+    // Consumer side: move every published record to out, returns how many
+    size_t drain(std::vector<TaskInfo>& out);
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<TaskInfo> records;
+    const uint64_t mask;
+    uint64_t sequence = 0;
+    std::atomic<uint64_t> dropped{0};
+    // Written by the producer and the consumer respectively, kept apart
+    alignas(64) std::atomic<uint64_t> write_index{0};
+    alignas(64) std::atomic<uint64_t> read_index{0};
+};
+
+// Render task records as Chrome trace_event JSON, for chrome://tracing or Perfetto
+// One complete event per task on a track per worker; times are relative to the earliest record
+std::string toChromeTrace(const std::vector<TaskInfo>& tasks);
+
+#endif // TASK_TRACE_H
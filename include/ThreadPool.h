@@ -2,7 +2,7 @@
 #define THREAD_POOL_H
 
 #include <vector>
-#include <queue>
+#include <tuple>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -11,12 +11,98 @@
 #include <functional>
 #include <stdexcept>
 #include <atomic>
-#include <unordered_set>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include "WorkStealingDeque.h"
+#include "TaskFunction.h"
+#include "PriorityTaskQueue.h"
+#include "SlabAllocator.h"
+#include "TimerWheel.h"
+#include "CpuTopology.h"
+#include "Metrics.h"
+#include "TaskTrace.h"
+#include "Logger.h"
+#include "CancellationToken.h"
+
+template<class T> class Future;
+class ScheduleOperation;
+namespace detail { struct ForkJoinAccess; }
+
+// How a worker waits once it runs out of tasks: spin, then yield, then park
+struct IdlePolicy {
+    // Polls for work with a CPU pause hint in between
+    size_t spin_count = 0;
+    // Polls for work with a std::this_thread::yield() in between
+    size_t yield_count = 0;
+
+    // Park right away: no CPU use while idle, but every wakeup pays a context switch
+    static IdlePolicy park() { return IdlePolicy(); }
+
+    // Stay awake for a short while so tasks arriving in bursts start without a wakeup
+    static IdlePolicy spinThenPark(size_t spins = 4096, size_t yields = 64) {
+        IdlePolicy policy;
+        policy.spin_count = spins;
+        policy.yield_count = yields;
+        return policy;
+    }
+};
+
+// What a submission does when a bounded pool already holds capacity queued tasks
+enum class OverflowPolicy {
+    // Wait for room; from a pool worker the task runs inline instead, to avoid deadlock
+    Block,
+    // Throw std::runtime_error, tryEnqueue()/tryPost() fail in every policy
+    Reject,
+    // Run the task on the submitting thread
+    CallerRuns,
+    // Discard the oldest task of the lowest priority (its future gets broken_promise)
+    // Continuations of accepted work (graph nodes, then(), schedule(), parallel halves,
+    // strand drains) are never discarded; a worker runs its task inline if nothing else can go
+    DropOldest
+};
+
+// Automatic growing and shrinking of the worker count, off while max_threads is 0
+struct ElasticPolicy {
+    // Bounds on the number of workers; the constructor's count is clamped into them
+    size_t min_threads = 1;
+    size_t max_threads = 0;
+    // Grow when no worker is idle and this many tasks are queued...
+    size_t grow_queue_depth = 16;
+    // ...or queued tasks have not been picked up for this long
+    std::chrono::microseconds grow_wait = std::chrono::milliseconds(1);
+    // A worker above min_threads retires after being idle this long
+    std::chrono::milliseconds idle_timeout = std::chrono::seconds(5);
+
+    bool enabled() const { return max_threads > 0; }
+};
+
+// Construction-time settings of a ThreadPool
+struct ThreadPoolOptions {
+    IdlePolicy idle;
+    ElasticPolicy elastic;
+    // Maximum number of queued (not yet running) tasks, 0 for unbounded
+    size_t capacity = 0;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    // Pin worker i to cpus[i % cpus.size()], empty to leave placement to the OS
+    std::vector<int> cpus;
+    // Group workers per NUMA node, each group with its own queue; submissions
+    // go to the submitting thread's node and workers prefer their own node
+    bool numa_aware = false;
+    // Layout for numa_aware, read from /sys/devices/system/node when not set
+    std::optional<CpuTopology> topology;
+    // Per-task trace records, see collectTrace()
+    TraceOptions trace;
+    // Receives the pool's log messages at log_level and above, nothing is logged when null
+    std::shared_ptr<LogSink> logger;
+    LogLevel log_level = LogLevel::Info;
+};
 
 class ThreadPool {
 public:
     // Constructor to create a specified number of worker threads
-    ThreadPool(size_t threads);
+    ThreadPool(size_t threads, const ThreadPoolOptions& options = ThreadPoolOptions());
     
     // Disable copy constructor and assignment operator
     ThreadPool(const ThreadPool&) = delete;
@@ -30,6 +116,94 @@ public:
     auto enqueue(F&& f, Args&&... args) 
         -> std::future<typename std::invoke_result<F, Args...>::type>;
 
+    // Submit a task with an explicit priority
+    // Prioritized tasks always go through the shared queue, even from inside a worker
+    template<class F, class... Args>
+    auto enqueue(TaskPriority priority, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // Submit a task that is skipped if token is cancelled before a worker dequeues it
+    // The future of a skipped task holds a TaskCancelled error
+    template<class F, class... Args>
+    auto enqueue(const CancellationToken& token, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // Submit a task that is skipped if it is still queued at deadline (or token is cancelled)
+    template<class F, class... Args>
+    auto enqueueWithDeadline(std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    template<class F, class... Args>
+    auto enqueueWithDeadline(std::chrono::steady_clock::time_point deadline, const CancellationToken& token,
+                             F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>;
+
+    // Submit a range of callables under a single lock acquisition
+    // Wakes at most one idle worker per task, returns one future per callable
+    template<class InputIt>
+    auto enqueueBulk(InputIt first, InputIt last)
+        -> std::vector<std::future<std::invoke_result_t<
+               std::decay_t<typename std::iterator_traits<InputIt>::reference>&>>>;
+
+    // Submit a batch of callables, the returned future completes when all of them have run
+    // The first exception thrown by any callable is stored in the future
+    template<class F>
+    std::future<void> submitBatch(std::vector<F> batch);
+
+    // Submit a task returning a composable Future, see Future.h
+    template<class F, class... Args>
+    auto async(F&& f, Args&&... args)
+        -> Future<std::invoke_result_t<F, Args...>>;
+
+    // Awaitable that resumes the awaiting coroutine on a pool worker, see Coroutine.h
+    ScheduleOperation schedule();
+
+    // Submit a fire-and-forget task without any future machinery
+    // Exceptions are counted as failed tasks and passed to the error handler
+    template<class F>
+    void post(F&& f);
+
+    // Post a task that is skipped if token is cancelled before a worker dequeues it
+    template<class F>
+    void post(const CancellationToken& token, F&& f);
+
+    // Submit a task only if a bounded pool has room for it, never blocks
+    template<class F, class... Args>
+    auto tryEnqueue(F&& f, Args&&... args)
+        -> std::optional<std::future<typename std::invoke_result<F, Args...>::type>>;
+
+    // Post a task only if a bounded pool has room for it, returns false otherwise
+    template<class F>
+    bool tryPost(F&& f);
+
+    // Run f once after the given delay, the returned handle can cancel it
+    template<class Rep, class Period, class F>
+    TimerHandle scheduleAfter(std::chrono::duration<Rep, Period> delay, F&& f);
+
+    // Run f once at the given point in time
+    template<class Duration, class F>
+    TimerHandle scheduleAt(std::chrono::time_point<std::chrono::steady_clock, Duration> when, F&& f);
+
+    // Run f every period, starting one period from now, until cancelled
+    // Fixed rate: a slow callback does not delay the following runs, but runs never overlap;
+    // a run that falls due while the previous one is still queued or running is skipped
+    template<class Rep, class Period, class F>
+    TimerHandle scheduleEvery(std::chrono::duration<Rep, Period> period, F&& f);
+
+    // get the number of timers waiting to fire, cancelled ones are not counted
+    size_t getTimerCount();
+
+    // Set the handler for exceptions escaping fire-and-forget tasks
+    // Without a handler they are logged at LogLevel::Error
+    void setErrorHandler(std::function<void(std::exception_ptr)> handler);
+
+    // Same, with what is known about the failed task (its ID only if it was traced)
+    void setErrorHandler(std::function<void(std::exception_ptr, const TaskInfo&)> handler);
+
+    // Run one queued task on the calling thread, returns false if none was available
+    // Lets threads that wait for pool work help instead of blocking
+    bool runPendingTask();
+
     // get the number of threads in the pool
     size_t getThreadCount() const;
     
@@ -39,6 +213,12 @@ public:
     // get the number of tasks to be processed in the queue
     size_t getTaskCount();
 
+    // get the number of tasks of one priority waiting in the shared queue
+    size_t getTaskCount(TaskPriority priority) const;
+
+    // Serve a waiting lower-priority task after this many higher-priority dequeues
+    void setPriorityAging(size_t dequeues);
+
     // get the number of waiting threads
     size_t getWaitingThreadCount() const;
 
@@ -48,8 +228,49 @@ public:
     // get the number of failed tasks
     size_t getFailedTaskCount() const;
 
-    // Dynamically resize the thread pool
-    void resize(size_t threads);
+    // get the number of tasks skipped because they were cancelled or past their deadline
+    size_t getSkippedTaskCount() const;
+
+    // get the number of tasks refused because a bounded pool was full
+    size_t getRejectedTaskCount() const;
+
+    // get the number of queued tasks discarded by OverflowPolicy::DropOldest
+    size_t getDroppedTaskCount() const;
+
+    // get the number of tasks run by their submitter because a bounded pool was full
+    size_t getCallerRunTaskCount() const;
+
+    // get the number of NUMA node groups, 1 unless ThreadPoolOptions::numa_aware
+    size_t getNodeCount() const;
+
+    // get the number of workers that were successfully pinned to their CPUs
+    size_t getPinnedThreadCount() const;
+
+    // get the number of workers started by the elastic policy
+    size_t getScaleUpCount() const;
+
+    // get the number of workers retired by the elastic policy after idling
+    size_t getScaleDownCount() const;
+
+    // get the highest number of workers alive at the same time
+    size_t getPeakThreadCount() const;
+
+    // Collect all statistics, per worker and as latency histograms (see Metrics.h)
+    // Counters are summed over the workers on every call, keep it off hot paths
+    MetricsSnapshot snapshot() const;
+
+    // Take the task records buffered since the last call, ordered by start time
+    // Empty unless ThreadPoolOptions::trace is enabled; see toChromeTrace() for export
+    std::vector<TaskInfo> collectTrace();
+
+    // get the number of task records lost because a trace buffer was full
+    size_t getDroppedTraceCount() const;
+
+    // Dynamically resize the thread pool without blocking
+    // Growing starts threads right away; shrinking posts retirement tokens that the next
+    // workers to look for work consume, and a reaper thread joins them. The future
+    // becomes ready once no retirement is outstanding and every retired thread is joined.
+    std::future<void> resize(size_t threads);
 
     // Pause the thread pool
     void pause();
@@ -67,20 +288,270 @@ public:
     bool isStopped() const { return stop; }
     
 private:
+    template<class> friend class Future;
+    friend class TaskGroup;
+    friend class Strand;
+    friend class PartitionedExecutor;
+    friend class Partition;
+    friend class TaskGraph;
+    friend class ScheduleOperation;
+    friend struct detail::ForkJoinAccess;
+
+    // Per-worker state that other threads may touch (e.g. steal from)
+    struct alignas(64) WorkerSlot {
+        // Tasks submitted from inside this worker, popped LIFO by the owner, stolen FIFO by others
+        WorkStealingDeque<TaskFunction*> local_tasks;
+        // Worker ID, the slot's index
+        size_t id = 0;
+        // Victim selection state, only used by the owner
+        uint64_t rng_state;
+        // NUMA node group (index into queues) and the CPUs the worker pins itself to
+        size_t node = 0;
+        std::vector<int> cpus;
+        // Thread using this slot, joined by the reaper after it exits
+        std::thread thread;
+        // Slot holds a thread that was not joined yet, guarded by queue_mutex
+        bool running = false;
+        // Owner only: idle past ElasticPolicy::idle_timeout
+        bool idle_expired = false;
+        // Statistics of the tasks this worker ran, on their own cache lines
+        WorkerCounters counters;
+        // Trace records of the tasks this worker ran, null unless tracing is enabled
+        std::unique_ptr<TraceRing> trace;
+        // Set while the worker sleeps in parked_workers, both guarded by queue_mutex
+        bool parked = false;
+        std::condition_variable wakeup;
+    };
+
+    // Immutable snapshot of the worker slots, replaced (never mutated) when the pool grows
+    using SlotTable = std::vector<WorkerSlot*>;
+
     // Worker thread function
     void workerThread(size_t id); // Set to track unique thread IDs
+
+    // Wrap a callable and the promise for its result into a queueable task
+    template<class R, class Fn>
+    static TaskFunction packageTask(std::promise<R> promise, Fn&& fn);
+
+    // Same, but skipped with a TaskCancelled error once token is cancelled or deadline passed
+    template<class R, class Fn>
+    TaskFunction packageGuardedTask(std::promise<R> promise, CancellationToken token,
+                                    std::chrono::steady_clock::time_point deadline, Fn&& fn);
+
+    // Why a guarded task must not run, if it must not
+    static std::optional<TaskCancelled::Reason> skipReason(const CancellationToken& token,
+                                                          std::chrono::steady_clock::time_point deadline);
+
+    // Queue a task locally when called from a worker, otherwise on the injection queue
+    // Non-normal priorities always use the injection queue
+    // reserved: a queue slot of a bounded pool was already claimed for it
+    void submitTask(TaskFunction task, TaskPriority priority = TaskPriority::Normal,
+                    bool reserved = false);
+
+    // Queue a task that continues already accepted work (a strand drain, a graph node, a coroutine, a fork)
+    // Never refused or run inline by the overflow policy of a bounded pool
+    void submitUnbounded(TaskFunction task);
+
+    // Queue a batch of tasks with one lock acquisition and targeted wakeups
+    void submitTasks(std::vector<TaskFunction>& batch);
+
+    // Insert a timer into the wheel and wake a worker to track it if needed
+    TimerHandle addTimer(std::shared_ptr<TimerState> timer);
+
+    // Block an idle worker; one of them sleeps only until the next timer deadline
+    // Returns true if this worker was the timer keeper, requires queue_mutex
+    bool waitForWork(std::unique_lock<std::mutex>& lock);
+
+    // Move expired timers to the injection queue, requires queue_mutex
+    void fireDueTimers();
+
+    // Wake up to count idle workers after tasks were pushed onto a local deque
+    // A single wakeup prefers a worker of the given node group
+    void wakeIdleWorkers(size_t count, size_t node = 0);
+
+    // Poll for work for a bounded time before parking, as configured by the idle policy
+    void spinForWork();
+
+    // Whether a worker has anything to do, without taking the lock
+    bool hasWork() const;
+
+    // Sleep on the worker's own condition variable until unparked or the deadline passes
+    // Returns false if the deadline passed, requires queue_mutex
+    bool parkWorker(std::unique_lock<std::mutex>& lock, WorkerSlot* self,
+                    std::chrono::steady_clock::time_point deadline);
+
+    // Take the most recently parked worker off the parked list, null if none
+    // Prefers a worker of the given node group
+    // The caller notifies its wakeup after releasing queue_mutex, requires queue_mutex
+    WorkerSlot* takeParkedWorker(size_t node = 0);
+
+    // Wake up to count parked workers, requires queue_mutex
+    void unparkWorkers(size_t count);
+
+    // Report an exception that escaped a task
+    void reportError(std::exception_ptr error, const TaskInfo& info);
+
+    // Count the running task as failed and report an exception it caught from work it ran
+    void reportTaskError(std::exception_ptr error);
+
+    // Pass a message to the log sink if its level is enabled
+    // Each "{}" in message is replaced by first, then second
+    void log(LogLevel level, const char* message, int64_t first = 0, int64_t second = 0,
+             std::string detail = std::string()) const;
+
+    // Count the running task as failed although it captured its exception (into a Future)
+    void markTaskFailed();
+
+    // Count the running task as skipped rather than completed
+    void markTaskSkipped();
+
+    // Task frames of the local deques, taken from the slab heap of the submitting thread
+    static TaskFunction* newTaskFrame(TaskFunction task);
+    static void deleteTaskFrame(TaskFunction* frame) noexcept;
+
+    // Push a task submitted by one of our workers onto its local deque
+    void pushLocal(TaskFunction task, bool reserved);
+
+    // Claim a queue slot of a bounded pool, fails if capacity tasks are queued
+    bool reserveSlot();
+
+    // Claim a slot or apply the overflow policy, returns false if the task already ran inline
+    bool admitTask(TaskFunction& task);
+
+    // Run a task on the calling thread as if a worker had dequeued it
+    void runInline(TaskFunction& task);
+
+    // Discard the oldest queued task to make room, returns false if none was found
+    bool dropOldestTask();
+
+    // Account for a task taken off a queue (or a slot given back), waking a producer blocked on a full pool
+    void taskDequeued();
+
+    // Try to steal a task from a random victim's deque, self may be null for external threads
+    bool stealTask(WorkerSlot* self, TaskFunction& task);
+
+    // Pop the oldest task from the injection queue
+    bool popInjectedTask(TaskFunction& task);
+
+    // Node group whose queue a task submitted from this thread goes to
+    size_t submitNode() const;
+
+    // Pop from the queue of the given node group, then from the others
+    // Requires queue_mutex unless the queue backend is lock-free
+    bool popQueued(TaskFunction& task, size_t node);
+
+    // Number of queued tasks of one priority over all node groups
+    size_t queuedTasks(TaskPriority priority) const;
+
+    // Run a dequeued task and update the statistics
+    void runTask(TaskFunction& task);
+
+    // Counters of the calling thread: its worker slot, or the shared ones of non-workers
+    WorkerCounters& currentCounters();
+
+    // Whether the next task run by this thread is traced, per TraceOptions::sample_every
+    bool sampleTrace() const;
+
+    // Fill in the ID of a task record and buffer it
+    void recordTrace(TaskInfo& info);
+
+    // Retire finished or discarded tasks, waking waitForCompletion() only when it matters
+    void finishTasks(size_t count);
+
+    // Make sure slots exist for worker IDs [0, count), requires queue_mutex
+    void ensureWorkerSlots(size_t count);
+
+    // Start a worker on the lowest free slot, requires queue_mutex
+    void startWorker();
+
+    // Start a worker if the elastic policy asks for one
+    void maybeGrow();
+
+    // Start the reaper thread if it is not running yet, requires queue_mutex
+    void ensureReaper();
+
+    // Join exited workers and free their slots for reuse
+    void reaperThread();
+
+    // Complete resize() futures once no retirement is outstanding, requires queue_mutex
+    void settleResize();
+
+    // Worker context of the calling thread, set only on pool worker threads
+    static thread_local ThreadPool* current_pool;
+    static thread_local WorkerSlot* current_slot;
+    // Outcome of the task running on this thread, null outside of runTask()
+    static thread_local TaskOutcome* current_task_outcome;
     
-    // Container for worker threads
-    std::vector<std::thread> workers;
+    // Workers whose thread has not exited yet
+    std::atomic<size_t> live_workers{0};
 
-    std::unordered_set<size_t> threadsToStop;
+    // Per-worker slots, indexed by worker ID; only grows, guarded by queue_mutex
+    // IDs of exited workers are reused, so the slots stay dense
+    std::vector<std::unique_ptr<WorkerSlot>> slot_storage;
+    std::vector<std::unique_ptr<SlotTable>> slot_tables;
+    std::atomic<const SlotTable*> slot_table{nullptr};
+
+    // Retirement tokens posted by resize() and not consumed yet, written under queue_mutex
+    std::atomic<size_t> retire_tokens{0};
+    // Exited workers waiting to be joined, and whether the reaper is joining some right now
+    // Guarded by queue_mutex
+    std::vector<WorkerSlot*> exited_slots;
+    bool reaping = false;
+    std::thread reaper;
+    std::condition_variable reaper_wakeup;
+    // Promises of resize() calls waiting for retirements, guarded by queue_mutex
+    std::vector<std::promise<void>> resize_waiters;
+
+    // Elastic scaling settings and decisions
+    const ElasticPolicy elastic;
+    // Last time a task left a queue, steady_clock ticks; only kept in elastic mode
+    std::atomic<int64_t> last_dequeue{0};
+    // Set while one thread is starting an extra worker
+    std::atomic<bool> scaling{false};
+    std::atomic<size_t> scale_ups{0};
+    std::atomic<size_t> scale_downs{0};
+    std::atomic<size_t> peak_threads{0};
     
-    // Task queue
-    std::queue<std::function<void()>> tasks;
+    // Placement settings, fixed at construction
+    const CpuTopology topology;
+    const std::vector<int> pinned_cpus;
+    const bool numa_aware;
+    std::atomic<size_t> pinned_threads{0};
+
+    // Injection queues for tasks submitted from outside the pool, one per NUMA node group
+    // Each has one FIFO per priority; guarded by queue_mutex unless the backend is lock-free
+    std::vector<std::unique_ptr<InjectionQueue>> queues;
+
+    // Pending delayed and periodic tasks, guarded by queue_mutex except for liveCount()
+    TimerWheel timers;
+    // The idle worker sleeping until the next timer deadline (null if none), and until when
+    WorkerSlot* timer_keeper = nullptr;
+    std::chrono::steady_clock::time_point keeper_deadline;
+
+    // Parked workers, most recently parked last; guarded by queue_mutex
+    std::vector<WorkerSlot*> parked_workers;
+    const IdlePolicy idle_policy;
+
+    // Tasks waiting in the injection queue and all local deques
+    std::atomic<size_t> pending_tasks{0};
+    // Tasks submitted but not finished yet (pending or running)
+    std::atomic<size_t> outstanding_tasks{0};
+    // Threads blocked in waitForCompletion()
+    std::atomic<size_t> completion_waiters{0};
+
+    // Bound on pending_tasks and what happens above it, fixed at construction
+    const size_t queue_capacity;
+    const OverflowPolicy overflow_policy;
+    // Producers blocked waiting for room in a bounded pool
+    std::mutex space_mutex;
+    std::condition_variable space_available;
+    std::atomic<size_t> space_waiters{0};
+    // Count of workers blocked waiting for tasks
+    std::atomic<size_t> idle_threads{0};
     
     // Synchronization mechanisms
     std::mutex queue_mutex;
-    std::condition_variable condition;
+    std::mutex completion_mutex;
     std::condition_variable waitCondition;
     
     // Control for stopping the thread pool
@@ -89,39 +560,263 @@ private:
 
     // Count of active threads
     std::atomic<size_t> active_threads{0};
-    // Count of completed tasks
-    std::atomic<size_t> completed_tasks{0};
-    std::atomic<size_t> failed_tasks{0};
+    // Completed and failed tasks are counted per worker, these are for other threads
+    // (runPendingTask() helpers, CallerRuns submitters, inline continuations)
+    WorkerCounters external_counters;
+    std::atomic<size_t> rejected_tasks{0};
+    std::atomic<size_t> dropped_tasks{0};
+    std::atomic<size_t> caller_run_tasks{0};
+
+    // Tracing settings; records of non-workers share one ring under its mutex
+    // and collectTrace() calls are serialized by trace_mutex
+    const TraceOptions trace_options;
+    std::unique_ptr<TraceRing> external_trace;
+    std::mutex external_trace_mutex;
+    std::mutex trace_mutex;
+
+    // Where log messages go, fixed at construction
+    const std::shared_ptr<LogSink> log_sink;
+    const LogLevel log_level;
+
+    // Handler for exceptions escaping fire-and-forget tasks
+    std::mutex error_mutex;
+    std::function<void(std::exception_ptr, const TaskInfo&)> error_handler;
 };
 
 // Template function implementation
+template<class R, class Fn>
+TaskFunction ThreadPool::packageTask(std::promise<R> promise, Fn&& fn) {
+    return TaskFunction(
+        [promise = std::move(promise), fn = std::forward<Fn>(fn)]() mutable {
+            try {
+                if constexpr (std::is_void<R>::value) {
+                    fn();
+                    promise.set_value();
+                } else {
+                    promise.set_value(fn());
+                }
+            } catch(...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+}
+
 template<class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args) 
     -> std::future<typename std::invoke_result<F, Args...>::type> {
+    return enqueue(TaskPriority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class R, class Fn>
+TaskFunction ThreadPool::packageGuardedTask(std::promise<R> promise, CancellationToken token,
+                                            std::chrono::steady_clock::time_point deadline, Fn&& fn) {
+    return TaskFunction(
+        [this, promise = std::move(promise), token = std::move(token), deadline,
+         fn = std::forward<Fn>(fn)]() mutable {
+            if (auto reason = skipReason(token, deadline)) {
+                markTaskSkipped();
+                promise.set_exception(std::make_exception_ptr(TaskCancelled(*reason)));
+                return;
+            }
+            try {
+                if constexpr (std::is_void<R>::value) {
+                    fn();
+                    promise.set_value();
+                } else {
+                    promise.set_value(fn());
+                }
+            } catch(...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+}
+
+template<class F, class... Args>
+auto ThreadPool::enqueue(TaskPriority priority, F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
     
     using return_type = typename std::invoke_result<F, Args...>::type;
 
-    // Create task wrapper
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-    );
-    
-    std::future<return_type> result = task->get_future();
-    
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        
-        // Thread pool has stopped, cannot add tasks
-        if(stop) {
-            throw std::runtime_error("enqueue on stopped ThreadPool");
+    // Shared state comes from the slab pool, the task itself is stored inline
+    std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+    std::future<return_type> result = promise.get_future();
+
+    submitTask(packageTask(std::move(promise),
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+            return std::apply(fn, bound);
+        }), priority);
+    return result;
+}
+
+template<class F, class... Args>
+auto ThreadPool::enqueue(const CancellationToken& token, F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+    return enqueueWithDeadline(std::chrono::steady_clock::time_point::max(), token,
+                               std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+auto ThreadPool::enqueueWithDeadline(std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+    return enqueueWithDeadline(deadline, CancellationToken(), std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<class F, class... Args>
+auto ThreadPool::enqueueWithDeadline(std::chrono::steady_clock::time_point deadline, const CancellationToken& token,
+                                     F&& f, Args&&... args)
+    -> std::future<typename std::invoke_result<F, Args...>::type> {
+
+    using return_type = typename std::invoke_result<F, Args...>::type;
+
+    std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+    std::future<return_type> result = promise.get_future();
+
+    submitTask(packageGuardedTask(std::move(promise), token, deadline,
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+            return std::apply(fn, bound);
+        }));
+    return result;
+}
+
+template<class InputIt>
+auto ThreadPool::enqueueBulk(InputIt first, InputIt last)
+    -> std::vector<std::future<std::invoke_result_t<
+           std::decay_t<typename std::iterator_traits<InputIt>::reference>&>>> {
+
+    using callable_type = std::decay_t<typename std::iterator_traits<InputIt>::reference>;
+    using return_type = std::invoke_result_t<callable_type&>;
+
+    std::vector<std::future<return_type>> results;
+    std::vector<TaskFunction> batch;
+    for(; first != last; ++first) {
+        std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+        results.push_back(promise.get_future());
+        batch.push_back(packageTask(std::move(promise), callable_type(*first)));
+    }
+
+    submitTasks(batch);
+    return results;
+}
+
+template<class F>
+std::future<void> ThreadPool::submitBatch(std::vector<F> batch) {
+    // Completion state shared by every task of the batch
+    struct BatchState {
+        explicit BatchState(size_t count) : remaining(count) {}
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::promise<void> done;
+    };
+
+    auto state = std::make_shared<BatchState>(batch.size());
+    std::future<void> result = state->done.get_future();
+    if(batch.empty()) {
+        state->done.set_value();
+        return result;
+    }
+
+    std::vector<TaskFunction> tasks;
+    tasks.reserve(batch.size());
+    for(auto& f : batch) {
+        tasks.emplace_back([state, fn = std::move(f)]() mutable {
+            try {
+                fn();
+            } catch(...) {
+                // Keep only the first error, published by the decrement below
+                if(!state->failed.exchange(true)) {
+                    state->error = std::current_exception();
+                }
+            }
+            if(state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if(state->error) {
+                    state->done.set_exception(state->error);
+                } else {
+                    state->done.set_value();
+                }
+            }
+        });
+    }
+
+    submitTasks(tasks);
+    return result;
+}
+
+template<class Rep, class Period, class F>
+TimerHandle ThreadPool::scheduleAfter(std::chrono::duration<Rep, Period> delay, F&& f) {
+    return scheduleAt(std::chrono::steady_clock::now() + delay, std::forward<F>(f));
+}
+
+template<class Duration, class F>
+TimerHandle ThreadPool::scheduleAt(std::chrono::time_point<std::chrono::steady_clock, Duration> when, F&& f) {
+    auto timer = std::make_shared<TimerState>();
+    timer->callback = std::forward<F>(f);
+    timer->expiry_tick = timers.tickAt(when);
+    return addTimer(std::move(timer));
+}
+
+template<class Rep, class Period, class F>
+TimerHandle ThreadPool::scheduleEvery(std::chrono::duration<Rep, Period> period, F&& f) {
+    auto ticks = std::chrono::ceil<std::chrono::steady_clock::duration>(period) / TimerWheel::kTick;
+    if(ticks <= 0) {
+        throw std::invalid_argument("scheduleEvery needs a period of at least one timer tick");
+    }
+
+    auto timer = std::make_shared<TimerState>();
+    timer->callback = std::forward<F>(f);
+    timer->period_ticks = static_cast<uint64_t>(ticks);
+    timer->expiry_tick = timers.tickAt(std::chrono::steady_clock::now() + period);
+    return addTimer(std::move(timer));
+}
+
+template<class F>
+void ThreadPool::post(F&& f) {
+    // The callable is queued as-is, no promise or shared state
+    submitTask(TaskFunction(std::forward<F>(f)));
+}
+
+template<class F>
+void ThreadPool::post(const CancellationToken& token, F&& f) {
+    submitTask(TaskFunction([this, token, fn = std::forward<F>(f)]() mutable {
+        if (token.isCancelled()) {
+            markTaskSkipped();
+            return;
         }
-        
-        // Add task to the queue
-        tasks.emplace([task]() { (*task)(); });
+        fn();
+    }));
+}
+
+template<class F, class... Args>
+auto ThreadPool::tryEnqueue(F&& f, Args&&... args)
+    -> std::optional<std::future<typename std::invoke_result<F, Args...>::type>> {
+
+    using return_type = typename std::invoke_result<F, Args...>::type;
+
+    if (queue_capacity > 0 && !reserveSlot()) {
+        ++rejected_tasks;
+        return std::nullopt;
     }
-    
-    condition.notify_one();
+
+    std::promise<return_type> promise(std::allocator_arg, SlabAllocator<return_type>());
+    std::future<return_type> result = promise.get_future();
+    submitTask(packageTask(std::move(promise),
+        [fn = std::forward<F>(f),
+         bound = std::make_tuple(std::forward<Args>(args)...)]() mutable -> return_type {
+            return std::apply(fn, bound);
+        }), TaskPriority::Normal, queue_capacity > 0);
     return result;
 }
 
+template<class F>
+bool ThreadPool::tryPost(F&& f) {
+    if (queue_capacity > 0 && !reserveSlot()) {
+        ++rejected_tasks;
+        return false;
+    }
+    submitTask(TaskFunction(std::forward<F>(f)), TaskPriority::Normal, queue_capacity > 0);
+    return true;
+}
+
 #endif // THREAD_POOL_H
\ No newline at end of file
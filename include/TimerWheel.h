@@ -0,0 +1,154 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// State of one scheduled timer, shared between the wheel, its handle and a queued firing.
+//
+// The callback belongs to whoever moved the phase away from Idle: a firing
+// task owns it while the timer is Firing, cancel() only drops it when Idle.
+struct TimerState {
+    enum Phase : int {
+        // Waiting in the wheel
+        Idle,
+        // A run is queued or in progress
+        Firing,
+        Cancelled,
+        // A one-shot timer that has run
+        Done
+    };
+
+    std::function<void()> callback;
+    // Zero for one-shot timers
+    uint64_t period_ticks = 0;
+    // Absolute tick at which the timer fires next
+    uint64_t expiry_tick = 0;
+    std::atomic<int> phase{Idle};
+    // Live timer count of the wheel it was added to, shared so handles may outlive the wheel
+    std::shared_ptr<std::atomic<size_t>> live;
+
+    // Claim an expired timer for a firing task
+    // False if it was cancelled or its previous run is still queued or running
+    bool beginFiring();
+
+    // Run the callback of a claimed timer unless cancelled meanwhile, then release the claim
+    void fire();
+
+    // Give a claimed timer back: periodic ones become Idle, otherwise the callback is dropped
+    void endFiring();
+
+    // Stop the timer; the callback is dropped now, or by the firing task if one is queued or running
+    void cancel();
+
+    bool isCancelled() const { return phase.load(std::memory_order_acquire) == Cancelled; }
+};
+
+// Owns a claimed firing of a timer, gives it back if destroyed without running
+class TimerFiring {
+public:
+    explicit TimerFiring(std::shared_ptr<TimerState> timer) : timer(std::move(timer)) {}
+    TimerFiring(TimerFiring&&) noexcept = default;
+    TimerFiring& operator=(TimerFiring&&) = delete;
+
+    ~TimerFiring() {
+        if (timer) {
+            timer->endFiring();
+        }
+    }
+
+    void run() {
+        std::shared_ptr<TimerState> claimed = std::move(timer);
+        claimed->fire();
+    }
+
+private:
+    std::shared_ptr<TimerState> timer;
+};
+
+// Handle returned by the scheduling functions of ThreadPool
+class TimerHandle {
+public:
+    TimerHandle() = default;
+    explicit TimerHandle(std::shared_ptr<TimerState> state) : state(std::move(state)) {}
+
+    // Cancel the timer and release its callback, O(1): the wheel drops the entry when its slot is next visited
+    // A queued run is skipped, a run in progress finishes
+    void cancel() {
+        if (state) {
+            state->cancel();
+        }
+    }
+
+    bool isCancelled() const {
+        return state && state->isCancelled();
+    }
+
+    explicit operator bool() const { return state != nullptr; }
+
+private:
+    std::shared_ptr<TimerState> state;
+};
+
+// Hierarchical timing wheel with 1 ms ticks.
+//
+// Four levels of 64 slots each cover 64^4 ticks (about 4.6 hours); longer
+// timers wait in an overflow list that is re-examined every 64^3 ticks.
+// Insertion is O(1), cancellation is an O(1) flag, and a timer is moved
+// down at most once per level. Occupancy bitmaps make computing the next
+// deadline and skipping empty ticks cheap. Not thread-safe.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr Clock::duration kTick = std::chrono::milliseconds(1);
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 6;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+
+    explicit TimerWheel(Clock::time_point start = Clock::now());
+
+    // Insert a timer, fires no earlier than the next tick
+    void add(std::shared_ptr<TimerState> timer);
+
+    // Tick at or after the given point in time
+    uint64_t tickAt(Clock::time_point when) const;
+
+    // Advance to now, appending timers that expired (periodic ones are re-armed)
+    void advance(Clock::time_point now, std::vector<std::shared_ptr<TimerState>>& expired);
+
+    // Earliest point at which advance() has work to do, time_point::max() if empty
+    Clock::time_point nextDeadline() const;
+
+    // Entries still in the wheel, including cancelled ones not visited yet
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Timers that have not been cancelled and may still fire, safe to read without the wheel's lock
+    size_t liveCount() const { return live->load(std::memory_order_acquire); }
+
+private:
+    using Slot = std::vector<std::shared_ptr<TimerState>>;
+
+    // Put a timer with expiry_tick >= current_tick into its slot
+    void place(std::shared_ptr<TimerState> timer);
+
+    // Redistribute the slots that start at tick boundary
+    void cascade(uint64_t boundary);
+
+    // Tick at which the next occupied slot of a level has to be visited
+    uint64_t nextOccupiedTick(size_t level) const;
+
+    Clock::time_point start;
+    uint64_t current_tick = 0;
+    size_t count = 0;
+    std::shared_ptr<std::atomic<size_t>> live = std::make_shared<std::atomic<size_t>>(0);
+    Slot slots[kLevels][kSlots];
+    uint64_t occupied[kLevels] = {};
+    Slot overflow;
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,136 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Lock-free Chase-Lev work-stealing deque.
+//
+// The owning thread pushes and pops at the bottom (LIFO), any other thread
+// may steal from the top (FIFO). Elements must be trivially copyable, the
+// thread pool stores raw task pointers. Based on "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli 2013).
+template<class T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 256)
+        : array(new Array(roundUpToPowerOfTwo(capacity))) {}
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque() {
+        delete array.load(std::memory_order_relaxed);
+    }
+
+    // Push an element at the bottom, only called by the owner thread
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+
+        if(b - t > a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+
+        a->put(b, item);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Pop an element from the bottom, only called by the owner thread
+    bool pop(T& item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if(t > b) {
+            // Deque was empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = a->get(b);
+        if(t == b) {
+            // Last element, race against concurrent stealers
+            bool won = top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Steal an element from the top, may be called by any thread
+    bool steal(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if(t >= b) {
+            return false;
+        }
+
+        Array* a = array.load(std::memory_order_acquire);
+        item = a->get(t);
+        return top.compare_exchange_strong(t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate number of elements, exact only when called by the owner
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    // Circular buffer of atomic slots, replaced (never shrunk) when full
+    struct Array {
+        explicit Array(int64_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t i) const {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T item) {
+            slots[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    static int64_t roundUpToPowerOfTwo(size_t n) {
+        int64_t cap = 2;
+        while(cap < static_cast<int64_t>(n)) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    Array* grow(Array* old, int64_t t, int64_t b) {
+        Array* bigger = new Array(old->capacity * 2);
+        for(int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        // Stealers may still read the old buffer, keep it alive until destruction
+        retired.emplace_back(old);
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> retired;
+};
+
+#endif // WORK_STEALING_DEQUE_H
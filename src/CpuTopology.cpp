@@ -0,0 +1,145 @@
+#include "CpuTopology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Every CPU the standard library knows about, as one node
+std::vector<NumaNode> singleNode() {
+    NumaNode node;
+    unsigned count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned cpu = 0; cpu < count; ++cpu) {
+        node.cpus.push_back(static_cast<int>(cpu));
+    }
+    return {node};
+}
+
+} // namespace
+
+CpuTopology::CpuTopology() : CpuTopology(singleNode()) {}
+
+CpuTopology::CpuTopology(std::vector<NumaNode> nodes) : node_list(std::move(nodes)) {
+    if (node_list.empty()) {
+        node_list = singleNode();
+    }
+    for (size_t index = 0; index < node_list.size(); ++index) {
+        for (int cpu : node_list[index].cpus) {
+            if (cpu < 0) {
+                continue;
+            }
+            if (static_cast<size_t>(cpu) >= cpu_to_node.size()) {
+                cpu_to_node.resize(cpu + 1, 0);
+            }
+            cpu_to_node[cpu] = index;
+        }
+    }
+}
+
+// Read the topology below root, falls back to a single node
+CpuTopology CpuTopology::detect(const std::string& root) {
+    namespace fs = std::filesystem;
+
+    std::vector<NumaNode> nodes;
+    std::error_code error;
+    for (fs::directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+
+        std::ifstream file(it->path() / "cpulist");
+        std::string text;
+        if (!std::getline(file, text)) {
+            continue;
+        }
+
+        NumaNode node;
+        node.id = std::atoi(name.c_str() + 4);
+        node.cpus = parseCpuList(text);
+        // Memory-only nodes have no CPUs to run workers on
+        if (!node.cpus.empty()) {
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return CpuTopology(std::move(nodes));
+}
+
+// Parse a sysfs CPU list such as "0-3,8-11", returns an empty list on malformed input
+std::vector<int> CpuTopology::parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < text.size() && text[pos] != '\n') {
+        char* end = nullptr;
+        long first = std::strtol(text.c_str() + pos, &end, 10);
+        size_t next = end - text.c_str();
+        if (next == pos || first < 0) {
+            return {};
+        }
+        long last = first;
+        if (next < text.size() && text[next] == '-') {
+            pos = next + 1;
+            last = std::strtol(text.c_str() + pos, &end, 10);
+            next = end - text.c_str();
+            if (next == pos || last < first) {
+                return {};
+            }
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+
+        pos = next;
+        if (pos < text.size() && text[pos] == ',') {
+            ++pos;
+        } else if (pos < text.size() && text[pos] != '\n') {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+// Bind the calling thread to the given CPUs, returns false if unsupported or refused
+bool CpuTopology::pinCurrentThread(const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool any = false;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+            any = true;
+        }
+    }
+    return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// CPU the calling thread runs on, -1 if unknown
+int CpuTopology::currentCpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+// Index into nodes() of the node owning cpu, 0 if unknown
+size_t CpuTopology::nodeIndexOfCpu(int cpu) const {
+    if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_to_node.size()) {
+        return 0;
+    }
+    return cpu_to_node[cpu];
+}
@@ -0,0 +1,120 @@
+#include "Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+// Name of a level, e.g. "INFO"
+const char* toString(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO";
+    case LogLevel::Warning: return "WARNING";
+    case LogLevel::Error: return "ERROR";
+    case LogLevel::Off: return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+// Render a record as one line without a newline: "<time> <LEVEL> <message>[: <detail>]"
+std::string formatLogRecord(const LogRecord& record) {
+    // UTC time of day with microseconds
+    std::time_t seconds = static_cast<std::time_t>(record.time / 1000000000);
+    std::tm parts{};
+#if defined(_WIN32)
+    gmtime_s(&parts, &seconds);
+#else
+    gmtime_r(&seconds, &parts);
+#endif
+    char stamp[32];
+    std::snprintf(stamp, sizeof(stamp), "%02d:%02d:%02d.%06lld", parts.tm_hour, parts.tm_min, parts.tm_sec,
+                  static_cast<long long>(record.time % 1000000000 / 1000));
+
+    std::string line = stamp;
+    line += ' ';
+    line += toString(record.level);
+    line += ' ';
+
+    size_t next = 0;
+    for (const char* p = record.message; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && next < 2) {
+            line += std::to_string(record.values[next++]);
+            ++p;
+        } else {
+            line += *p;
+        }
+    }
+    if (!record.detail.empty()) {
+        line += ": ";
+        line += record.detail;
+    }
+    return line;
+}
+
+void StreamLogSink::write(const LogRecord& record) {
+    std::string line = formatLogRecord(record);
+    std::lock_guard<std::mutex> lock(mutex);
+    out << line << '\n';
+    out.flush();
+}
+
+AsyncLogSink::AsyncLogSink(std::shared_ptr<LogSink> target, size_t capacity)
+    : target(std::move(target)), records(capacity) {
+    thread = std::thread(&AsyncLogSink::run, this);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    thread.join();
+}
+
+void AsyncLogSink::write(const LogRecord& record) {
+    LogRecord copy = record;
+    if (!records.tryPush(std::move(copy))) {
+        ++dropped;
+        return;
+    }
+    ++accepted;
+    if (sleeping) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_one();
+    }
+}
+
+// Block until every record accepted so far has reached the target
+void AsyncLogSink::flush() {
+    uint64_t target_count = accepted;
+    std::unique_lock<std::mutex> lock(mutex);
+    wakeup.notify_one();
+    drained.wait(lock, [&] { return written >= target_count; });
+}
+
+// Background thread: pass queued records to the target until stopped
+void AsyncLogSink::run() {
+    LogRecord record;
+    while (true) {
+        while (records.tryPop(record)) {
+            try {
+                target->write(record);
+            } catch(...) {
+                // A failing target loses the record, not the thread
+            }
+            ++written;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.notify_all();
+        if (stopping && records.empty()) {
+            return;
+        }
+        // A writer may miss the flag while it is being set, the timeout bounds that delay
+        sleeping = true;
+        wakeup.wait_for(lock, std::chrono::milliseconds(10), [this] {
+            return stopping || !records.empty();
+        });
+        sleeping = false;
+    }
+}
@@ -0,0 +1,140 @@
+#include "Metrics.h"
+#include <sstream>
+
+namespace {
+
+// Bucket bounds of the exported Prometheus histograms, in seconds
+const double kExportBounds[] = {
+    1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+    1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+void writeHeader(std::ostringstream& out, const std::string& name, const char* type, const char* help) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+void writeValue(std::ostringstream& out, const std::string& name, const char* type, const char* help,
+                uint64_t value) {
+    writeHeader(out, name, type, help);
+    out << name << " " << value << "\n";
+}
+
+// Per-worker counter family, one sample per worker
+template<class Field>
+void writeWorkerValues(std::ostringstream& out, const std::string& name, const char* help,
+                       const std::vector<WorkerMetrics>& workers, Field field) {
+    writeHeader(out, name, "counter", help);
+    for (const WorkerMetrics& worker : workers) {
+        out << name << "{worker=\"" << worker.id << "\"} " << worker.*field << "\n";
+    }
+}
+
+// Histogram in seconds; a bucket is counted below a bound if all of its values are
+void writeHistogram(std::ostringstream& out, const std::string& name, const char* help,
+                    const HistogramSnapshot& histogram) {
+    writeHeader(out, name, "histogram", help);
+    size_t bucket = 0;
+    uint64_t cumulative = 0;
+    for (double bound : kExportBounds) {
+        uint64_t limit = static_cast<uint64_t>(bound * 1e9);
+        while (bucket < histogram.buckets.size() && LatencyHistogram::bucketUpperBound(bucket) <= limit) {
+            cumulative += histogram.buckets[bucket++];
+        }
+        out << name << "_bucket{le=\"" << bound << "\"} " << cumulative << "\n";
+    }
+    out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n";
+    out << name << "_sum " << histogram.sum / 1e9 << "\n";
+    out << name << "_count " << histogram.count << "\n";
+}
+
+} // namespace
+
+// Value in nanoseconds below which the fraction p (0..1) of the samples fall, 0 if empty
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return LatencyHistogram::bucketUpperBound(bucket);
+        }
+    }
+    return LatencyHistogram::bucketUpperBound(buckets.size() - 1);
+}
+
+// Add another histogram's counts to this one
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (buckets.size() < other.buckets.size()) {
+        buckets.resize(other.buckets.size(), 0);
+    }
+    for (size_t bucket = 0; bucket < other.buckets.size(); ++bucket) {
+        buckets[bucket] += other.buckets[bucket];
+    }
+    count += other.count;
+    sum += other.sum;
+}
+
+// Add the current counts to a snapshot
+void LatencyHistogram::addTo(HistogramSnapshot& snapshot) const {
+    snapshot.buckets.resize(kBuckets, 0);
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        uint64_t count = buckets[bucket].load(std::memory_order_relaxed);
+        snapshot.buckets[bucket] += count;
+        snapshot.count += count;
+    }
+    snapshot.sum += total.load(std::memory_order_relaxed);
+}
+
+// Largest value that falls into a bucket
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+    uint64_t sub = bucket % kSubBuckets + kSubBuckets;
+    // Wraps to UINT64_MAX for the last bucket
+    return ((sub + 1) << shift) - 1;
+}
+
+// Render a snapshot in the Prometheus text exposition format
+std::string toPrometheus(const MetricsSnapshot& snapshot, const std::string& prefix) {
+    std::ostringstream out;
+    writeValue(out, prefix + "_threads", "gauge", "Worker threads", snapshot.threads);
+    writeValue(out, prefix + "_active_threads", "gauge", "Threads running a task", snapshot.active_threads);
+    writeValue(out, prefix + "_pending_tasks", "gauge", "Tasks waiting in the queues", snapshot.pending_tasks);
+    writeValue(out, prefix + "_tasks_completed_total", "counter", "Tasks that finished normally", snapshot.completed);
+    writeValue(out, prefix + "_tasks_failed_total", "counter", "Tasks that ended in an exception", snapshot.failed);
+    writeValue(out, prefix + "_tasks_skipped_total", "counter", "Tasks cancelled or expired before they ran", snapshot.skipped);
+    writeValue(out, prefix + "_tasks_rejected_total", "counter", "Submissions refused by a full pool", snapshot.rejected);
+    writeValue(out, prefix + "_tasks_dropped_total", "counter", "Queued tasks discarded by DropOldest", snapshot.dropped);
+    writeValue(out, prefix + "_tasks_caller_runs_total", "counter", "Tasks run by their submitter", snapshot.caller_runs);
+    writeValue(out, prefix + "_scale_ups_total", "counter", "Workers started by the elastic policy", snapshot.scale_ups);
+    writeValue(out, prefix + "_scale_downs_total", "counter", "Workers retired by the elastic policy", snapshot.scale_downs);
+
+    writeValue(out, prefix + "_allocator_hits_total", "counter", "Allocations served from slab memory", snapshot.allocator.hits);
+    writeValue(out, prefix + "_allocator_misses_total", "counter", "Allocations that reached the global heap", snapshot.allocator.misses);
+    writeValue(out, prefix + "_allocator_remote_frees_total", "counter", "Blocks freed by another thread than their owner", snapshot.allocator.remote_frees);
+    writeValue(out, prefix + "_allocator_bytes_in_use", "gauge", "Bytes allocated and not freed", snapshot.allocator.bytes_in_use);
+    writeValue(out, prefix + "_allocator_bytes_reserved", "gauge", "Bytes taken from the global heap", snapshot.allocator.bytes_reserved);
+    writeValue(out, prefix + "_allocator_peak_bytes_reserved", "gauge", "Most bytes ever taken from the global heap", snapshot.allocator.peak_bytes_reserved);
+
+    writeWorkerValues(out, prefix + "_worker_tasks_completed_total", "Tasks a worker finished normally",
+                      snapshot.workers, &WorkerMetrics::completed);
+    writeWorkerValues(out, prefix + "_worker_tasks_failed_total", "Tasks of a worker that ended in an exception",
+                      snapshot.workers, &WorkerMetrics::failed);
+    writeWorkerValues(out, prefix + "_worker_tasks_stolen_total", "Tasks a worker stole from another",
+                      snapshot.workers, &WorkerMetrics::stolen);
+    writeWorkerValues(out, prefix + "_worker_parks_total", "Times a worker went to sleep",
+                      snapshot.workers, &WorkerMetrics::parked);
+
+    if (!snapshot.queue_wait.buckets.empty()) {
+        writeHistogram(out, prefix + "_queue_wait_seconds", "Time from submission to start", snapshot.queue_wait);
+    }
+    if (!snapshot.execution.buckets.empty()) {
+        writeHistogram(out, prefix + "_execution_seconds", "Time from start to end of a task", snapshot.execution);
+    }
+    return out.str();
+}
@@ -0,0 +1,400 @@
+#include "PartitionedExecutor.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#if defined(__linux__)
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Virtual time a weight-1 partition advances per dispatched task
+constexpr uint64_t kStride = uint64_t(1) << 20;
+
+#if defined(__linux__)
+// Scheduling settings of the calling worker: what it started with and what is applied now
+struct ThreadSchedule {
+    bool saved = false;
+    int base_nice = 0;
+    int base_policy = SCHED_OTHER;
+    int nice = 0;
+    int policy = SCHED_OTHER;
+};
+
+thread_local ThreadSchedule thread_schedule;
+
+// setpriority() with this ID changes the calling thread only
+id_t threadId() {
+    return static_cast<id_t>(syscall(SYS_gettid));
+}
+#endif
+
+// Switch the calling worker to a partition's settings, or back to its own when niced is false
+// Changes are skipped when the setting is already in place; failures keep the current one
+void applyThreadSchedule(bool niced, int nice, bool batch) {
+#if defined(__linux__)
+    ThreadSchedule& schedule = thread_schedule;
+    if (!schedule.saved) {
+        errno = 0;
+        int current = getpriority(PRIO_PROCESS, threadId());
+        schedule.base_nice = errno == 0 ? current : 0;
+        schedule.base_policy = sched_getscheduler(0);
+        schedule.nice = schedule.base_nice;
+        schedule.policy = schedule.base_policy;
+        schedule.saved = true;
+    }
+
+    int targetNice = niced ? nice : schedule.base_nice;
+    if (targetNice != schedule.nice && setpriority(PRIO_PROCESS, threadId(), targetNice) == 0) {
+        schedule.nice = targetNice;
+    }
+    // Only the time-sharing policies are switched, real-time workers keep theirs
+    if (schedule.base_policy == SCHED_OTHER || schedule.base_policy == SCHED_BATCH) {
+        int targetPolicy = batch ? SCHED_BATCH : schedule.base_policy;
+        if (targetPolicy != schedule.policy) {
+            sched_param param{};
+            if (sched_setscheduler(0, targetPolicy, &param) == 0) {
+                schedule.policy = targetPolicy;
+            }
+        }
+    }
+#else
+    (void)niced;
+    (void)nice;
+    (void)batch;
+#endif
+}
+
+// Whether a worker could take this nice value and then return to its own
+// Unprivileged processes may raise their nice value but not lower it again
+bool canSwitchNice(int nice) {
+#if defined(__linux__)
+    bool switched = false;
+    std::thread probe([nice, &switched] {
+        errno = 0;
+        int base = getpriority(PRIO_PROCESS, threadId());
+        if (errno != 0) {
+            return;
+        }
+        switched = setpriority(PRIO_PROCESS, threadId(), nice) == 0 &&
+                   setpriority(PRIO_PROCESS, threadId(), base) == 0;
+    });
+    probe.join();
+    return switched;
+#else
+    (void)nice;
+    return false;
+#endif
+}
+
+} // namespace
+
+Partition::Partition(PartitionedExecutor& executor, PartitionOptions options)
+    : executor(executor), options(std::move(options)), stride(kStride / this->options.weight) {}
+
+size_t Partition::getQueuedTaskCount() const {
+    std::lock_guard<std::mutex> lock(executor.mutex);
+    return queue.size();
+}
+
+size_t Partition::getRunningTaskCount() const {
+    std::lock_guard<std::mutex> lock(executor.mutex);
+    return running;
+}
+
+uint64_t Partition::getCompletedTaskCount() const {
+    std::lock_guard<std::mutex> lock(executor.mutex);
+    return completed;
+}
+
+uint64_t Partition::getFailedTaskCount() const {
+    std::lock_guard<std::mutex> lock(executor.mutex);
+    return failed;
+}
+
+PartitionedExecutor::PartitionedExecutor(ThreadPool& pool, size_t max_workers)
+    : pool(pool), max_workers(std::max<size_t>(1, max_workers ? max_workers : pool.getThreadCount())) {}
+
+PartitionedExecutor::~PartitionedExecutor() {
+    // Runner tasks point back at us
+    wait();
+}
+
+Partition& PartitionedExecutor::addPartition(PartitionOptions options) {
+    if (options.weight == 0) {
+        throw std::invalid_argument("partition weight must be at least 1");
+    }
+    if (options.max_workers != 0 && options.max_workers < options.min_workers) {
+        throw std::invalid_argument("partition max_workers is below its min_workers");
+    }
+
+    if (options.nice && !canSwitchNice(*options.nice)) {
+        pool.log(LogLevel::Warning, "Workers cannot switch to nice {} and back, partition runs without it",
+                 *options.nice, 0, options.name);
+        options.nice.reset();
+    }
+#if !defined(__linux__)
+    options.batch_scheduling = false;
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& partition : partitions) {
+        if (partition->options.name == options.name) {
+            throw std::invalid_argument("duplicate partition name: " + options.name);
+        }
+    }
+    if (reserved + options.min_workers > max_workers) {
+        throw std::invalid_argument("partition min_workers exceed the executor's workers");
+    }
+    reserved += options.min_workers;
+    uses_thread_settings = uses_thread_settings || options.nice || options.batch_scheduling;
+    partitions.push_back(std::unique_ptr<Partition>(new Partition(*this, std::move(options))));
+    return *partitions.back();
+}
+
+Partition* PartitionedExecutor::getPartition(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& partition : partitions) {
+        if (partition->options.name == name) {
+            return partition.get();
+        }
+    }
+    return nullptr;
+}
+
+// Block until every partition is empty and idle, helping with queued pool tasks
+void PartitionedExecutor::wait() {
+    auto done = [this] { return queued == 0 && active == 0 && runners == 0; };
+    auto finished = [this, &done] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return done();
+    };
+    // Our runners may be sitting in the pool's queues behind other work
+    while (!finished() && pool.runPendingTask()) {
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, done);
+}
+
+size_t PartitionedExecutor::getRunningTaskCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return active;
+}
+
+// Queue a task and start a runner if it may run right away and one is free
+void PartitionedExecutor::submit(Partition& partition, TaskFunction task) {
+    bool start = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Waking up: no credit for the time spent idle
+        if (partition.queue.empty() && partition.running == 0) {
+            partition.pass = std::max(partition.pass, virtual_time);
+        }
+        partition.queue.push_back(std::move(task));
+        ++queued;
+        if (runners < max_workers && dispatchable(partition, unusedReservation())) {
+            ++runners;
+            start = true;
+        }
+    }
+    // A refused runner gives its slot back itself and drops the queued tasks
+    if (start) {
+        postRunner();
+    }
+}
+
+// Reserved workers the partitions do not use right now, requires mutex
+size_t PartitionedExecutor::unusedReservation() const {
+    size_t unused = 0;
+    for (const auto& partition : partitions) {
+        if (partition->running < partition->options.min_workers) {
+            unused += partition->options.min_workers - partition->running;
+        }
+    }
+    return unused;
+}
+
+// Whether partition may start another task now, requires mutex
+bool PartitionedExecutor::dispatchable(const Partition& partition, size_t unused_reservation) const {
+    if (partition.queue.empty() || active >= max_workers) {
+        return false;
+    }
+    if (partition.options.max_workers != 0 && partition.running >= partition.options.max_workers) {
+        return false;
+    }
+    if (partition.running < partition.options.min_workers) {
+        return true;
+    }
+    // Beyond its own reservation it must leave the others' unused reservations free
+    return active + unused_reservation < max_workers;
+}
+
+// The partition to run next, its task claimed; null if none may run, requires mutex
+Partition* PartitionedExecutor::pick() {
+    size_t unused = unusedReservation();
+    Partition* best = nullptr;
+    bool bestUnderMin = false;
+    for (const auto& candidate : partitions) {
+        Partition* partition = candidate.get();
+        if (!dispatchable(*partition, unused)) {
+            continue;
+        }
+        // Partitions below their reservation first, then the one furthest behind in virtual time
+        bool underMin = partition->running < partition->options.min_workers;
+        if (!best || (underMin && !bestUnderMin) ||
+            (underMin == bestUnderMin && partition->pass < best->pass)) {
+            best = partition;
+            bestUnderMin = underMin;
+        }
+    }
+    if (!best) {
+        return nullptr;
+    }
+
+    virtual_time = std::max(virtual_time, best->pass);
+    best->pass += best->stride;
+    ++best->running;
+    ++active;
+    --queued;
+    return best;
+}
+
+// Run partition tasks on the calling worker until none may run or the batch is done
+void PartitionedExecutor::runBatch() {
+    std::unique_lock<std::mutex> lock(mutex);
+    bool settings = uses_thread_settings;
+    size_t ran = 0;
+    while (ran < kRunnerBatch) {
+        Partition* partition = pick();
+        if (!partition) {
+            break;
+        }
+        TaskFunction task = std::move(partition->queue.front());
+        partition->queue.pop_front();
+        lock.unlock();
+
+        if (settings) {
+            applyThreadSchedule(partition->options.nice.has_value(), partition->options.nice.value_or(0),
+                                partition->options.batch_scheduling);
+        }
+        bool ok = true;
+        try {
+            task();
+        } catch(...) {
+            ok = false;
+            pool.reportTaskError(std::current_exception());
+        }
+        // The callable may submit from its destructor, so it goes before relocking
+        task = TaskFunction();
+
+        lock.lock();
+        --partition->running;
+        --active;
+        if (ok) {
+            ++partition->completed;
+        } else {
+            ++partition->failed;
+        }
+        ++ran;
+    }
+
+    bool more = false;
+    if (ran == kRunnerBatch) {
+        size_t unused = unusedReservation();
+        for (const auto& partition : partitions) {
+            more = more || dispatchable(*partition, unused);
+        }
+    }
+    if (!more) {
+        --runners;
+        notifyIfIdle();
+    }
+    lock.unlock();
+
+    // The worker goes back to running plain pool tasks
+    if (settings) {
+        applyThreadSchedule(false, 0, false);
+    }
+    if (more) {
+        try {
+            postRunner();
+        } catch(...) {
+            // The refused runner already gave its slot back
+        }
+    }
+}
+
+// Post a runner task for a runner slot already counted in runners
+void PartitionedExecutor::postRunner() {
+    pool.submitUnbounded(TaskFunction([handle = RunnerHandle(this)]() mutable {
+        PartitionedExecutor* executor = handle.executor;
+        handle.executor = nullptr;
+        executor->runBatch();
+    }));
+}
+
+// A runner task was destroyed without running
+void PartitionedExecutor::runnerLost() {
+    bool restart = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --runners;
+        restart = runners == 0 && queued > 0;
+        notifyIfIdle();
+    }
+    if (restart) {
+        restartOrDrop();
+    }
+}
+
+// No runner is left although tasks are queued: start one or, if the pool refuses, drop them
+void PartitionedExecutor::restartOrDrop() {
+    if (!pool.isStopped()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (runners > 0 || queued == 0) {
+                return;
+            }
+            ++runners;
+        }
+        try {
+            postRunner();
+            return;
+        } catch(...) {
+            // The refused runner gave its slot back and found the pool stopped
+        }
+    }
+
+    // Destroyed outside the lock: futures of dropped enqueue() tasks get broken_promise
+    std::vector<TaskFunction> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (runners > 0) {
+            return;
+        }
+        for (const auto& partition : partitions) {
+            for (auto& task : partition->queue) {
+                dropped.push_back(std::move(task));
+            }
+            queued -= partition->queue.size();
+            partition->queue.clear();
+        }
+        notifyIfIdle();
+    }
+    if (!dropped.empty()) {
+        pool.log(LogLevel::Warning, "Pool refused the partition runners, dropped {} queued tasks",
+                 static_cast<int64_t>(dropped.size()));
+    }
+}
+
+// Wake wait() once everything is idle, requires mutex
+void PartitionedExecutor::notifyIfIdle() {
+    if (queued == 0 && active == 0 && runners == 0) {
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,207 @@
+#include "SlabAllocator.h"
+#include <algorithm>
+
+thread_local SlabPool::Heap* SlabPool::current_heap = nullptr;
+thread_local bool SlabPool::heap_released = false;
+
+// The pool is intentionally leaked so blocks freed during static destruction stay valid
+SlabPool& SlabPool::instance() {
+    static SlabPool* pool = new SlabPool();
+    return *pool;
+}
+
+// Map a request size to its size class
+size_t SlabPool::classIndex(size_t size) {
+    size_t index = 0;
+    size_t blockSize = kMinBlockSize;
+    while (blockSize < size) {
+        blockSize <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+SlabPool::HeapRelease::~HeapRelease() {
+    SlabPool::instance().releaseHeap(current_heap);
+    current_heap = nullptr;
+    heap_released = true;
+}
+
+// Heap of the calling thread, created or adopted on first use
+SlabPool::Heap* SlabPool::threadHeap() {
+    Heap* heap = current_heap;
+    if (heap || heap_released) {
+        return heap;
+    }
+    heap = adoptHeap();
+    current_heap = heap;
+    // Constructed here so that it is destroyed before the thread_locals that existed already
+    static thread_local HeapRelease release;
+    (void)release;
+    return heap;
+}
+
+// Take the heap of an exited thread, or register a new one
+SlabPool::Heap* SlabPool::adoptHeap() {
+    std::lock_guard<std::mutex> lock(heaps_mutex);
+    if (orphans) {
+        Heap* heap = orphans;
+        orphans = heap->next_orphan;
+        heap->next_orphan = nullptr;
+        return heap;
+    }
+    Heap* heap = new Heap();
+    heap->next_heap = heaps;
+    heaps = heap;
+    return heap;
+}
+
+// Park a heap until another thread adopts it, its blocks stay valid meanwhile
+void SlabPool::releaseHeap(Heap* heap) {
+    if (!heap) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(heaps_mutex);
+    heap->next_orphan = orphans;
+    orphans = heap;
+}
+
+// Allocate a block from the calling thread's heap
+void* SlabPool::allocate(size_t size) {
+    if (size > kMaxBlockSize) {
+        void* p = ::operator new(size);
+        oversize_allocations.fetch_add(1, std::memory_order_relaxed);
+        oversize_bytes.fetch_add(size, std::memory_order_relaxed);
+        reserve(size);
+        return p;
+    }
+
+    size_t index = classIndex(size);
+    if (Heap* heap = threadHeap()) {
+        return allocateFrom(*heap, index);
+    }
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    return allocateFrom(shared_heap, index);
+}
+
+// Local free list first, then the blocks other threads gave back, then the newest chunk
+void* SlabPool::allocateFrom(Heap& heap, size_t index) {
+    size_t blockSize = kMinBlockSize << index;
+    FreeBlock* block = heap.free_list[index];
+    if (!block && heap.remote_free[index].load(std::memory_order_relaxed)) {
+        block = heap.remote_free[index].exchange(nullptr, std::memory_order_acquire);
+    }
+
+    if (block) {
+        heap.free_list[index] = block->next;
+        heap.hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        if (heap.carve[index] == heap.carve_end[index]) {
+            addChunk(heap, index);
+            heap.misses.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            heap.hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        block = reinterpret_cast<FreeBlock*>(heap.carve[index]);
+        heap.carve[index] += blockSize;
+    }
+    heap.allocated_bytes.fetch_add(blockSize, std::memory_order_relaxed);
+    return block;
+}
+
+// Give a heap a fresh chunk for a size class, its blocks are carved on demand
+void SlabPool::addChunk(Heap& heap, size_t index) {
+    size_t blockSize = kMinBlockSize << index;
+    char* chunk = static_cast<char*>(::operator new(kChunkSize, std::align_val_t(kChunkSize)));
+    ::new (static_cast<void*>(chunk)) ChunkHeader{&heap};
+
+    size_t blocks = (kChunkSize - sizeof(ChunkHeader)) / blockSize;
+    heap.carve[index] = chunk + sizeof(ChunkHeader);
+    heap.carve_end[index] = heap.carve[index] + blocks * blockSize;
+    chunk_count.fetch_add(1, std::memory_order_relaxed);
+    reserve(kChunkSize);
+}
+
+// Account for memory taken from the global heap, keeping the peak
+void SlabPool::reserve(size_t bytes) {
+    size_t reserved = reserved_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peak_reserved_bytes.load(std::memory_order_relaxed);
+    while (peak < reserved &&
+           !peak_reserved_bytes.compare_exchange_weak(peak, reserved, std::memory_order_relaxed)) {
+    }
+}
+
+// Return a block to the heap it came from
+void SlabPool::deallocate(void* p, size_t size) noexcept {
+    if (!p) {
+        return;
+    }
+    if (size > kMaxBlockSize) {
+        ::operator delete(p);
+        oversize_bytes.fetch_sub(size, std::memory_order_relaxed);
+        reserved_bytes.fetch_sub(size, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t index = classIndex(size);
+    size_t blockSize = kMinBlockSize << index;
+    auto* chunk = reinterpret_cast<ChunkHeader*>(reinterpret_cast<uintptr_t>(p) & ~(kChunkSize - 1));
+    Heap* owner = chunk->heap;
+    // Freeing never creates a heap, threads that only free have none
+    Heap* self = current_heap;
+    auto* block = static_cast<FreeBlock*>(p);
+
+    if (owner == self) {
+        block->next = self->free_list[index];
+        self->free_list[index] = block;
+    } else {
+        std::atomic<FreeBlock*>& list = owner->remote_free[index];
+        FreeBlock* head = list.load(std::memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!list.compare_exchange_weak(head, block, std::memory_order_release,
+                                             std::memory_order_relaxed));
+        if (self) {
+            self->remote_frees.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            unowned_remote_frees.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (self) {
+        self->freed_bytes.fetch_add(blockSize, std::memory_order_relaxed);
+    } else {
+        unowned_freed_bytes.fetch_add(blockSize, std::memory_order_relaxed);
+    }
+}
+
+// Sum the per-heap counters, approximate while other threads allocate
+SlabStats SlabPool::stats() const {
+    SlabStats stats;
+    uint64_t allocated = 0;
+    uint64_t freed = unowned_freed_bytes.load(std::memory_order_relaxed);
+    auto add = [&](const Heap& heap) {
+        stats.hits += heap.hits.load(std::memory_order_relaxed);
+        stats.misses += heap.misses.load(std::memory_order_relaxed);
+        stats.remote_frees += heap.remote_frees.load(std::memory_order_relaxed);
+        allocated += heap.allocated_bytes.load(std::memory_order_relaxed);
+        freed += heap.freed_bytes.load(std::memory_order_relaxed);
+    };
+    {
+        std::lock_guard<std::mutex> lock(heaps_mutex);
+        for (const Heap* heap = heaps; heap; heap = heap->next_heap) {
+            add(*heap);
+        }
+    }
+    add(shared_heap);
+
+    size_t oversize = oversize_bytes.load(std::memory_order_relaxed);
+    stats.misses += oversize_allocations.load(std::memory_order_relaxed);
+    stats.remote_frees += unowned_remote_frees.load(std::memory_order_relaxed);
+    stats.bytes_in_use = static_cast<size_t>(allocated > freed ? allocated - freed : 0) + oversize;
+    stats.bytes_reserved = reserved_bytes.load(std::memory_order_relaxed);
+    stats.peak_bytes_reserved = std::max(peak_reserved_bytes.load(std::memory_order_relaxed),
+                                         stats.bytes_reserved);
+    stats.chunks = chunk_count.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,170 @@
+#include "TaskGraph.h"
+#include <future>
+#include <stdexcept>
+
+// This node runs before other
+TaskGraph::Node& TaskGraph::Node::precede(Node other) {
+    graph->addEdge(data, other.data);
+    return *this;
+}
+
+// This node runs after other
+TaskGraph::Node& TaskGraph::Node::succeed(Node other) {
+    graph->addEdge(other.data, data);
+    return *this;
+}
+
+void TaskGraph::addEdge(NodeData* from, NodeData* to) {
+    if (running) {
+        throw std::logic_error("TaskGraph modified while running");
+    }
+    from->successors.push_back(to);
+    ++to->predecessors;
+    validated = false;
+}
+
+// Throw if the graph contains a cycle (Kahn's algorithm)
+void TaskGraph::validate() {
+    if (validated) {
+        return;
+    }
+
+    std::vector<NodeData*> ready;
+    for (auto& node : nodes) {
+        node.remaining.store(node.predecessors, std::memory_order_relaxed);
+        if (node.predecessors == 0) {
+            ready.push_back(&node);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeData* node = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (NodeData* next : node->successors) {
+            if (next->remaining.fetch_sub(1, std::memory_order_relaxed) == 1) {
+                ready.push_back(next);
+            }
+        }
+    }
+
+    if (visited != nodes.size()) {
+        throw std::logic_error("TaskGraph contains a cycle");
+    }
+    validated = true;
+}
+
+// Run the whole graph on the pool
+std::future<void> TaskGraph::run(ThreadPool& pool) {
+    if (running.exchange(true)) {
+        throw std::logic_error("TaskGraph is already running");
+    }
+
+    try {
+        validate();
+    } catch(...) {
+        running = false;
+        throw;
+    }
+
+    completion = std::promise<void>();
+    std::future<void> result = completion.get_future();
+    if (nodes.empty()) {
+        running = false;
+        completion.set_value();
+        return result;
+    }
+
+    // Reset the per-run state, counters are re-armed from the static in-degrees
+    this->pool = &pool;
+    error = nullptr;
+    failed = false;
+    std::vector<NodeData*> roots;
+    for (auto& node : nodes) {
+        node.remaining.store(node.predecessors, std::memory_order_relaxed);
+        if (node.predecessors == 0) {
+            roots.push_back(&node);
+        }
+    }
+    remaining_nodes.store(nodes.size(), std::memory_order_release);
+
+    for (NodeData* root : roots) {
+        post(root);
+    }
+    return result;
+}
+
+// Queue execute(node) on the pool, bypassing the overflow policy
+void TaskGraph::post(NodeData* node) {
+    try {
+        pool->submitUnbounded(TaskFunction([handle = NodeHandle(this, node)]() mutable {
+            TaskGraph* graph = handle.graph;
+            handle.graph = nullptr;
+            graph->execute(handle.node);
+        }));
+    } catch(...) {
+        // The refused task's handle already counted the node down
+    }
+}
+
+// A queued node was dropped: fail the run and count the node and its subtree down
+void TaskGraph::nodeLost(NodeData* node) {
+    fail(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    execute(node);
+}
+
+// Record the first failure, the remaining nodes are only counted down
+void TaskGraph::fail(std::exception_ptr failure) {
+    if (!failed.exchange(true)) {
+        error = std::move(failure);
+    }
+}
+
+// Run a node and then, inline, one of the successors it made ready
+void TaskGraph::execute(NodeData* node) {
+    // Ready successors of a failed run, counted down on this thread instead of posted
+    std::vector<NodeData*> unposted;
+    while (node) {
+        // After a failure the remaining nodes are only counted down
+        if (!failed.load(std::memory_order_relaxed)) {
+            try {
+                node->work();
+            } catch(...) {
+                fail(std::current_exception());
+            }
+        }
+
+        NodeData* next = nullptr;
+        for (NodeData* successor : node->successors) {
+            if (successor->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (!next) {
+                    next = successor;
+                } else if (failed.load(std::memory_order_relaxed)) {
+                    unposted.push_back(successor);
+                } else {
+                    post(successor);
+                }
+            }
+        }
+
+        // Last node: the graph may be re-run or destroyed as soon as the promise is set
+        if (remaining_nodes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::exception_ptr failure = error;
+            std::promise<void> done = std::move(completion);
+            running = false;
+            if (failure) {
+                done.set_exception(failure);
+            } else {
+                done.set_value();
+            }
+            return;
+        }
+
+        node = next;
+        if (!node && !unposted.empty()) {
+            node = unposted.back();
+            unposted.pop_back();
+        }
+    }
+}
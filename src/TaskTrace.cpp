@@ -0,0 +1,112 @@
+#include "TaskTrace.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace {
+
+// Smallest power of two not below n, at least 1
+uint64_t roundUpPow2(size_t n) {
+    uint64_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Append s as a JSON string literal
+void writeJsonString(std::ostringstream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *s;
+        } else if (c < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << *s;
+        }
+    }
+    out << '"';
+}
+
+// Outcome as written to the trace
+const char* outcomeName(TaskOutcome outcome) {
+    switch (outcome) {
+    case TaskOutcome::Failed: return "failed";
+    case TaskOutcome::Skipped: return "skipped";
+    default: return "completed";
+    }
+}
+
+// Track of a record: workers get their ID + 1, threads outside the pool share track 0
+uint64_t trackOf(const TaskInfo& info) {
+    return info.worker == TaskInfo::kExternalWorker ? 0 : static_cast<uint64_t>(info.worker) + 1;
+}
+
+} // namespace
+
+TraceRing::TraceRing(size_t capacity)
+    : records(roundUpPow2(capacity)), mask(records.size() - 1) {}
+
+// Consumer side: move every published record to out, returns how many
+size_t TraceRing::drain(std::vector<TaskInfo>& out) {
+    uint64_t tail = read_index.load(std::memory_order_relaxed);
+    uint64_t head = write_index.load(std::memory_order_acquire);
+    for (uint64_t index = tail; index != head; ++index) {
+        out.push_back(records[index & mask]);
+    }
+    read_index.store(head, std::memory_order_release);
+    return static_cast<size_t>(head - tail);
+}
+
+// Render task records as Chrome trace_event JSON, for chrome://tracing or Perfetto
+std::string toChromeTrace(const std::vector<TaskInfo>& tasks) {
+    uint64_t origin = UINT64_MAX;
+    std::map<uint64_t, size_t> tracks;
+    for (const TaskInfo& info : tasks) {
+        origin = std::min(origin, info.submit_time != 0 ? info.submit_time : info.start_time);
+        tracks.emplace(trackOf(info), info.worker);
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&] {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    for (const auto& track : tracks) {
+        separate();
+        out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << track.first
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        if (track.second == TaskInfo::kExternalWorker) {
+            out << "\"external\"";
+        } else {
+            out << "\"worker " << track.second << "\"";
+        }
+        out << "}}";
+    }
+
+    // Chrome wants microseconds
+    for (const TaskInfo& info : tasks) {
+        separate();
+        out << "{\"ph\":\"X\",\"cat\":\"task\",\"name\":";
+        writeJsonString(out, info.name ? info.name : "task");
+        out << ",\"pid\":1,\"tid\":" << trackOf(info)
+            << ",\"ts\":" << (info.start_time - origin) / 1e3
+            << ",\"dur\":" << (info.end_time - info.start_time) / 1e3
+            << ",\"args\":{\"id\":" << info.id
+            << ",\"outcome\":\"" << outcomeName(info.outcome) << "\"";
+        if (info.submit_time != 0) {
+            out << ",\"queue_wait_us\":" << (info.start_time - info.submit_time) / 1e3;
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+    return out.str();
+}
@@ -1,209 +1,1487 @@
-#include "ThreadPool.h"
-#include <iostream>
-
-// Constructor - Create a specified number of worker threads
-ThreadPool::ThreadPool(size_t threads) {
-    std::cout << "Thread pool constructor called, creating " << threads << " worker threads" << std::endl;
-    
-    for(size_t i = 0; i < threads; ++i) {
-        workers.emplace_back(
-            [this, i] { this->workerThread(i); }
-        );
-    }
-    
-    std::cout << "All worker threads created successfully" << std::endl;
-}
-
-// Destructor - Gracefully shut down the thread pool
-ThreadPool::~ThreadPool() {
-    std::cout << "Thread pool is starting to shut down..." << std::endl;
-    
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        stop = true;
-    }
-    
-    condition.notify_all();
-    
-    for(std::thread &worker : workers) {
-        if(worker.joinable()) {
-            worker.join();
-        }
-    }
-    
-    std::cout << "Thread pool has been closed"  << std::endl;
-}
-
-// Get the number of threads in the pool
-size_t ThreadPool::getThreadCount() const{
-    return workers.size();
-}
-    
-// Get the number of active threads
-size_t ThreadPool::getActiveThreadCount() const {
-    return active_threads;
-}
-
-// Get the number of tasks to be processed in the queue
-size_t ThreadPool::getTaskCount() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    return tasks.size();
-}
-
-// Get the number of waiting threads
-size_t ThreadPool::getWaitingThreadCount() const {
-    size_t totalThreads = getThreadCount();
-    size_t activeCount = getActiveThreadCount();
-    // Waiting threads = total threads - active threads
-    return totalThreads - activeCount;
-}
-
-// Get the number of completed tasks
-size_t ThreadPool::getCompletedTaskCount() const {
-    return completed_tasks;
-}
-
-// Get the number of failed tasks
-size_t ThreadPool::getFailedTaskCount() const {
-    return failed_tasks; // Assuming failed_tasks is a member variable
-}
-
-// Dynamically adjust the thread pool size
-void ThreadPool::resize(size_t threads) {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-
-    // If the thread pool has stopped, resizing is not allowed
-    if (stop) {
-        throw std::runtime_error("resize on stopped ThreadPool");
-    }
-
-    // Get the current number of threads
-    size_t oldSize = workers.size();
-
-    std::cout << "Adjusting thread pool size: " << oldSize << " -> " << threads << std::endl;
-
-    // If the new thread count is greater than the current count, add new threads
-    if (threads > oldSize) {
-        workers.reserve(threads);
-        for (size_t i = oldSize; i < threads; ++i) {
-            workers.emplace_back([this, i] { this->workerThread(i); });
-        }
-        std::cout << "Added " << (threads - oldSize) << " worker threads" << std::endl;
-    }
-    // If the new thread count is less than the current count, we need to reduce threads
-    else if (threads < oldSize) {
-        // Clear any previously marked threads to stop
-        threadsToStop.clear();
-
-        // Add thread IDs to the set of threads to stop
-        for (size_t i = threads; i < oldSize; ++i) {
-            threadsToStop.insert(i);
-        }
-
-        // Unlock and notify
-        lock.unlock();
-        condition.notify_all();
-
-        // Wait for threads to finish
-        for (size_t i = threads; i < oldSize; ++i) {
-            if (workers[i].joinable()) {
-                workers[i].join();
-            }
-        }
-
-        // Reacquire lock and resize the container
-        lock.lock();
-        workers.resize(threads);
-        std::cout << "Removed " << (oldSize - threads) << " worker threads" << std::endl;
-    }
-}
-
-// Pause the thread pool
-void ThreadPool::pause() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    paused = true;
-    std::cout << "Thread pool has been paused" << std::endl;
-}
-
-// Resume the thread pool
-void ThreadPool::resume() {
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        paused = false;
-        std::cout << "Thread pool has been resumed" << std::endl;
-    }
-    condition.notify_all();
-}
-
-// Wait for all tasks to complete
-void ThreadPool::waitForCompletion() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    std::cout << "Waiting for all tasks to complete..." << std::endl;
-    waitCondition.wait(lock, [this] {
-        return (tasks.empty() && active_threads == 0) || stop;
-    });
-    std::cout << "All tasks have been completed" << std::endl;
-}
-
-// Clear the task queue
-void ThreadPool::clearTasks() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    size_t taskCount = tasks.size();
-    
-    std::queue<std::function<void()>> emptyQueue;
-    std::swap(tasks, emptyQueue);
-    
-    std::cout << "Cleared task queue: " << taskCount << " tasks were removed" << std::endl;
-}
-
-// Worker thread function - with thread ID parameter
-void ThreadPool::workerThread(size_t id) {
-    while(true) {
-        std::function<void()> task;
-        
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            
-            // Wait until there is a task, the thread pool stops, or the thread needs to exit
-            condition.wait(lock, [this, id] {
-                return this->stop ||
-                       (!this->paused && !this->tasks.empty()) ||
-                       (this->threadsToStop.find(id) != this->threadsToStop.end());
-            });
-            
-            // First, check if the thread pool has stopped
-            if(this->stop) {
-                return;
-            }
-            
-            // Check if the current thread needs to terminate
-            if(this->threadsToStop.find(id) != this->threadsToStop.end()) {
-                this->threadsToStop.erase(id);
-                return;
-            }
-            
-            // Finally, check if there is a task to execute
-            if(!this->paused && !this->tasks.empty()) {
-                task = std::move(this->tasks.front());
-                this->tasks.pop();
-            }
-        }
-        
-        // Execute the task and handle exceptions
-        if(task) {
-            ++active_threads;  // Increment active thread count
-            try {
-                task();
-                ++completed_tasks;
-            } catch(const std::exception& e) {
-                std::cerr << "Exception occurred in task: " << e.what() << std::endl;
-                ++failed_tasks;
-            } catch(...) {
-                std::cerr << "Unknown exception occurred in task" << std::endl;
-                ++failed_tasks;
-            }
-            --active_threads;   // Decrement active thread count
-            waitCondition.notify_all();
-        }
-    }
-}
\ No newline at end of file
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+// Tell the CPU we are in a spin-wait loop
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Tasks this thread still skips before the next traced one
+thread_local uint32_t trace_countdown = 0;
+
+} // namespace
+
+thread_local ThreadPool* ThreadPool::current_pool = nullptr;
+thread_local ThreadPool::WorkerSlot* ThreadPool::current_slot = nullptr;
+thread_local TaskOutcome* ThreadPool::current_task_outcome = nullptr;
+
+// Constructor - Create a specified number of worker threads
+ThreadPool::ThreadPool(size_t threads, const ThreadPoolOptions& options)
+    : elastic(options.elastic),
+      topology(options.topology ? *options.topology
+                                : (options.numa_aware ? CpuTopology::detect() : CpuTopology())),
+      pinned_cpus(options.cpus),
+      numa_aware(options.numa_aware),
+      idle_policy(options.idle),
+      queue_capacity(options.capacity),
+      overflow_policy(options.overflow),
+      trace_options(options.trace),
+      log_sink(options.logger),
+      log_level(options.log_level) {
+    if (trace_options.enabled()) {
+        if (trace_options.sample_every == 0) {
+            throw std::invalid_argument("TraceOptions sample_every must be at least 1");
+        }
+        external_trace = std::make_unique<TraceRing>(trace_options.capacity);
+    }
+    if (elastic.enabled()) {
+        if (elastic.min_threads > elastic.max_threads) {
+            throw std::invalid_argument("ElasticPolicy min_threads exceeds max_threads");
+        }
+        threads = std::min(std::max(threads, elastic.min_threads), elastic.max_threads);
+        last_dequeue = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+    log(LogLevel::Info, "Thread pool constructor called, creating {} worker threads",
+        static_cast<int64_t>(threads));
+
+    // One queue per node group, a single-node machine ends up with just one
+    size_t nodes = numa_aware ? topology.nodeCount() : 1;
+    for (size_t node = 0; node < nodes; ++node) {
+        queues.push_back(std::make_unique<InjectionQueue>());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        ensureWorkerSlots(threads);
+        for(size_t i = 0; i < threads; ++i) {
+            startWorker();
+        }
+        // Idle workers retire on their own, somebody has to join them
+        if (elastic.enabled()) {
+            ensureReaper();
+        }
+    }
+    
+    log(LogLevel::Debug, "All worker threads created successfully");
+}
+
+// Destructor - Gracefully shut down the thread pool
+ThreadPool::~ThreadPool() {
+    log(LogLevel::Info, "Thread pool is starting to shut down...");
+    
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        stop = true;
+        unparkWorkers(parked_workers.size());
+    }
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex);
+        waitCondition.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(space_mutex);
+        space_available.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        reaper_wakeup.notify_all();
+    }
+
+    // The reaper first, it may be joining a worker; the rest are ours
+    if(reaper.joinable()) {
+        reaper.join();
+    }
+    // Slots never shrink, and after stop no worker can be started any more
+    for(auto& slot : slot_storage) {
+        if(slot->thread.joinable()) {
+            slot->thread.join();
+        }
+    }
+    for(auto& waiter : resize_waiters) {
+        waiter.set_value();
+    }
+
+    // Free tasks left behind, while the pool is still whole: their destructors may
+    // try to submit (and get refused since stop is set)
+    for(auto& slot : slot_storage) {
+        TaskFunction* task = nullptr;
+        while(slot->local_tasks.pop(task)) {
+            deleteTaskFrame(task);
+        }
+    }
+    for (auto& queue : queues) {
+        queue->clear();
+    }
+    
+    log(LogLevel::Info, "Thread pool has been closed");
+}
+
+// Get the number of threads in the pool
+size_t ThreadPool::getThreadCount() const{
+    // Workers holding a retirement token are as good as gone
+    return live_workers - retire_tokens;
+}
+    
+// Get the number of active threads
+size_t ThreadPool::getActiveThreadCount() const {
+    return active_threads;
+}
+
+// Get the number of tasks to be processed in the queue
+size_t ThreadPool::getTaskCount() {
+    return pending_tasks;
+}
+
+// Get the number of tasks of one priority waiting in the shared queue
+size_t ThreadPool::getTaskCount(TaskPriority priority) const {
+    return queuedTasks(priority);
+}
+
+// Serve a waiting lower-priority task after this many higher-priority dequeues
+void ThreadPool::setPriorityAging(size_t dequeues) {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    for (auto& queue : queues) {
+        queue->setAgingLimit(dequeues);
+    }
+}
+
+// Get the number of waiting threads
+size_t ThreadPool::getWaitingThreadCount() const {
+    size_t totalThreads = getThreadCount();
+    size_t activeCount = getActiveThreadCount();
+    // Waiting threads = total threads - active threads
+    // External threads helping via runPendingTask() also count as active
+    return activeCount >= totalThreads ? 0 : totalThreads - activeCount;
+}
+
+// Get the number of completed tasks
+size_t ThreadPool::getCompletedTaskCount() const {
+    uint64_t count = external_counters.completed.load(std::memory_order_relaxed);
+    for (WorkerSlot* slot : *slot_table.load(std::memory_order_acquire)) {
+        count += slot->counters.completed.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// Get the number of failed tasks
+size_t ThreadPool::getFailedTaskCount() const {
+    uint64_t count = external_counters.failed.load(std::memory_order_relaxed);
+    for (WorkerSlot* slot : *slot_table.load(std::memory_order_acquire)) {
+        count += slot->counters.failed.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// Get the number of tasks skipped because they were cancelled or past their deadline
+size_t ThreadPool::getSkippedTaskCount() const {
+    uint64_t count = external_counters.skipped.load(std::memory_order_relaxed);
+    for (WorkerSlot* slot : *slot_table.load(std::memory_order_acquire)) {
+        count += slot->counters.skipped.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// Collect all statistics, per worker and as latency histograms
+MetricsSnapshot ThreadPool::snapshot() const {
+    MetricsSnapshot snapshot;
+    snapshot.threads = getThreadCount();
+    snapshot.active_threads = active_threads;
+    snapshot.pending_tasks = pending_tasks;
+    snapshot.rejected = rejected_tasks;
+    snapshot.dropped = dropped_tasks;
+    snapshot.caller_runs = caller_run_tasks;
+    snapshot.scale_ups = scale_ups;
+    snapshot.scale_downs = scale_downs;
+    snapshot.allocator = SlabPool::instance().stats();
+
+    // Aggregated on read, the workers only ever touch their own counters
+    auto add = [&snapshot](const WorkerCounters& counters) {
+        snapshot.completed += counters.completed.load(std::memory_order_relaxed);
+        snapshot.failed += counters.failed.load(std::memory_order_relaxed);
+        snapshot.skipped += counters.skipped.load(std::memory_order_relaxed);
+#if THREADPOOL_METRICS
+        counters.queue_wait.addTo(snapshot.queue_wait);
+        counters.execution.addTo(snapshot.execution);
+#endif
+    };
+    add(external_counters);
+
+    const SlotTable& table = *slot_table.load(std::memory_order_acquire);
+    for (size_t id = 0; id < table.size(); ++id) {
+        const WorkerCounters& counters = table[id]->counters;
+        add(counters);
+
+        WorkerMetrics worker;
+        worker.id = id;
+        worker.completed = counters.completed.load(std::memory_order_relaxed);
+        worker.failed = counters.failed.load(std::memory_order_relaxed);
+        worker.stolen = counters.stolen.load(std::memory_order_relaxed);
+        worker.parked = counters.parked.load(std::memory_order_relaxed);
+        snapshot.workers.push_back(worker);
+    }
+    return snapshot;
+}
+
+// Take the task records buffered since the last call, ordered by start time
+std::vector<TaskInfo> ThreadPool::collectTrace() {
+    std::vector<TaskInfo> tasks;
+    if (!trace_options.enabled()) {
+        return tasks;
+    }
+
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    for (WorkerSlot* slot : *slot_table.load(std::memory_order_acquire)) {
+        slot->trace->drain(tasks);
+    }
+    external_trace->drain(tasks);
+    std::sort(tasks.begin(), tasks.end(), [](const TaskInfo& a, const TaskInfo& b) {
+        return a.start_time < b.start_time;
+    });
+    return tasks;
+}
+
+// Get the number of task records lost because a trace buffer was full
+size_t ThreadPool::getDroppedTraceCount() const {
+    if (!trace_options.enabled()) {
+        return 0;
+    }
+    uint64_t count = external_trace->droppedCount();
+    for (WorkerSlot* slot : *slot_table.load(std::memory_order_acquire)) {
+        count += slot->trace->droppedCount();
+    }
+    return count;
+}
+
+// Get the number of NUMA node groups
+size_t ThreadPool::getNodeCount() const {
+    return queues.size();
+}
+
+// Get the number of workers that were successfully pinned to their CPUs
+size_t ThreadPool::getPinnedThreadCount() const {
+    return pinned_threads;
+}
+
+// Get the number of workers started by the elastic policy
+size_t ThreadPool::getScaleUpCount() const {
+    return scale_ups;
+}
+
+// Get the number of workers retired by the elastic policy after idling
+size_t ThreadPool::getScaleDownCount() const {
+    return scale_downs;
+}
+
+// Get the highest number of workers alive at the same time
+size_t ThreadPool::getPeakThreadCount() const {
+    return peak_threads;
+}
+
+// Get the number of tasks refused because a bounded pool was full
+size_t ThreadPool::getRejectedTaskCount() const {
+    return rejected_tasks;
+}
+
+// Get the number of queued tasks discarded by OverflowPolicy::DropOldest
+size_t ThreadPool::getDroppedTaskCount() const {
+    return dropped_tasks;
+}
+
+// Get the number of tasks run by their submitter because a bounded pool was full
+size_t ThreadPool::getCallerRunTaskCount() const {
+    return caller_run_tasks;
+}
+
+// Dynamically adjust the thread pool size, never waits for workers to exit
+std::future<void> ThreadPool::resize(size_t threads) {
+    std::promise<void> done;
+    std::future<void> result = done.get_future();
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+    // If the thread pool has stopped, resizing is not allowed
+    if (stop) {
+        throw std::runtime_error("resize on stopped ThreadPool");
+    }
+
+    // Get the current number of threads, ignoring ones already on their way out
+    size_t oldSize = live_workers - retire_tokens;
+
+    log(LogLevel::Info, "Adjusting thread pool size: {} -> {}",
+        static_cast<int64_t>(oldSize), static_cast<int64_t>(threads));
+
+    // If the new thread count is greater than the current count, add new threads
+    if (threads > oldSize) {
+        // Withdraw unconsumed tokens first, those workers simply stay
+        size_t kept = std::min<size_t>(retire_tokens, threads - oldSize);
+        retire_tokens -= kept;
+        size_t started = threads - oldSize - kept;
+        for (size_t i = 0; i < started; ++i) {
+            startWorker();
+        }
+        log(LogLevel::Debug, "Added {} worker threads, kept {} retiring ones",
+            static_cast<int64_t>(started), static_cast<int64_t>(kept));
+    }
+    // If the new thread count is less than the current count, post retirement tokens
+    else if (threads < oldSize) {
+        ensureReaper();
+        retire_tokens += oldSize - threads;
+
+        // Wake everyone so idle workers pick the tokens up
+        unparkWorkers(parked_workers.size());
+        log(LogLevel::Debug, "Retiring {} worker threads", static_cast<int64_t>(oldSize - threads));
+    }
+
+    resize_waiters.push_back(std::move(done));
+    settleResize();
+    return result;
+}
+
+// Start the reaper thread if it is not running yet, requires queue_mutex
+void ThreadPool::ensureReaper() {
+    if (!reaper.joinable()) {
+        reaper = std::thread([this] { this->reaperThread(); });
+    }
+}
+
+// Join exited workers and free their slots for reuse
+void ThreadPool::reaperThread() {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true) {
+        reaper_wakeup.wait(lock, [this] { return stop || !exited_slots.empty(); });
+        // The destructor joins whatever is left
+        if (stop) {
+            return;
+        }
+
+        std::vector<WorkerSlot*> exited;
+        exited.swap(exited_slots);
+        reaping = true;
+        lock.unlock();
+
+        // They have left workerThread(), so these joins are short
+        for (WorkerSlot* slot : exited) {
+            slot->thread.join();
+        }
+
+        lock.lock();
+        reaping = false;
+        for (WorkerSlot* slot : exited) {
+            slot->running = false;
+        }
+        settleResize();
+    }
+}
+
+// Complete resize() futures once no retirement is outstanding, requires queue_mutex
+void ThreadPool::settleResize() {
+    if (retire_tokens > 0 || !exited_slots.empty() || reaping) {
+        return;
+    }
+    for (auto& waiter : resize_waiters) {
+        waiter.set_value();
+    }
+    resize_waiters.clear();
+}
+
+// Pause the thread pool
+void ThreadPool::pause() {
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        paused = true;
+    }
+    log(LogLevel::Info, "Thread pool has been paused");
+}
+
+// Resume the thread pool
+void ThreadPool::resume() {
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        paused = false;
+        unparkWorkers(parked_workers.size());
+    }
+    log(LogLevel::Info, "Thread pool has been resumed");
+}
+
+// Wait for all tasks to complete
+void ThreadPool::waitForCompletion() {
+    log(LogLevel::Debug, "Waiting for all tasks to complete...");
+    std::unique_lock<std::mutex> lock(completion_mutex);
+    // Registered before the predicate is checked, finishTasks() reads it after decrementing
+    ++completion_waiters;
+    waitCondition.wait(lock, [this] {
+        return outstanding_tasks == 0 || stop;
+    });
+    --completion_waiters;
+    lock.unlock();
+    log(LogLevel::Debug, "All tasks have been completed");
+}
+
+// Clear the task queue
+void ThreadPool::clearTasks() {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    // Destroyed after unlocking: a task's destructor may submit work (e.g. a strand drain)
+    std::vector<TaskFunction> removed;
+    std::vector<TaskFunction*> removedLocal;
+    size_t taskCount = 0;
+    for (auto& queue : queues) {
+        taskCount += queue->clear(removed);
+    }
+
+    // Local deques can only be drained from the top by non-owners
+    for(auto& slot : slot_storage) {
+        TaskFunction* task = nullptr;
+        while(slot->local_tasks.steal(task)) {
+            removedLocal.push_back(task);
+            ++taskCount;
+        }
+    }
+    pending_tasks -= taskCount;
+    lock.unlock();
+    removed.clear();
+    for (TaskFunction* task : removedLocal) {
+        deleteTaskFrame(task);
+    }
+    finishTasks(taskCount);
+
+    // Producers blocked on a full pool have room now
+    if (space_waiters > 0) {
+        std::lock_guard<std::mutex> spaceLock(space_mutex);
+        space_available.notify_all();
+    }
+    
+    log(LogLevel::Info, "Cleared task queue: {} tasks were removed", static_cast<int64_t>(taskCount));
+}
+
+// Make sure slots exist for worker IDs [0, count), requires queue_mutex
+void ThreadPool::ensureWorkerSlots(size_t count) {
+    if (slot_storage.size() >= count) {
+        return;
+    }
+
+    while (slot_storage.size() < count) {
+        size_t id = slot_storage.size();
+        auto slot = std::make_unique<WorkerSlot>();
+        slot->id = id;
+        if (trace_options.enabled()) {
+            slot->trace = std::make_unique<TraceRing>(trace_options.capacity);
+        }
+        slot->rng_state = 0x9E3779B97F4A7C15ULL * (id + 1);
+
+        // Explicit CPUs win, otherwise NUMA groups are filled round-robin and span their node
+        if (!pinned_cpus.empty()) {
+            int cpu = pinned_cpus[id % pinned_cpus.size()];
+            slot->cpus.push_back(cpu);
+            slot->node = numa_aware ? topology.nodeIndexOfCpu(cpu) : 0;
+        } else if (numa_aware) {
+            slot->node = id % queues.size();
+            slot->cpus = topology.nodes()[slot->node].cpus;
+        }
+        slot_storage.push_back(std::move(slot));
+    }
+
+    // Each worker is parked at most once, parking never allocates
+    parked_workers.reserve(slot_storage.size());
+
+    // Publish a new snapshot, old ones stay alive for concurrent stealers
+    auto table = std::make_unique<SlotTable>();
+    for (auto& slot : slot_storage) {
+        table->push_back(slot.get());
+    }
+    slot_table.store(table.get(), std::memory_order_release);
+    slot_tables.push_back(std::move(table));
+}
+
+// Start a worker on the lowest free slot, requires queue_mutex
+void ThreadPool::startWorker() {
+    size_t id = 0;
+    while (id < slot_storage.size() && slot_storage[id]->running) {
+        ++id;
+    }
+    ensureWorkerSlots(id + 1);
+
+    WorkerSlot* slot = slot_storage[id].get();
+    slot->running = true;
+    slot->idle_expired = false;
+    slot->thread = std::thread([this, id] { this->workerThread(id); });
+
+    size_t live = ++live_workers;
+    size_t peak = peak_threads;
+    while (live > peak && !peak_threads.compare_exchange_weak(peak, live)) {
+    }
+}
+
+// Start a worker if the elastic policy asks for one
+void ThreadPool::maybeGrow() {
+    // Cheap checks first: an idle worker or a full pool means there is nothing to do
+    if (idle_threads > 0 || live_workers >= elastic.max_threads || stop) {
+        return;
+    }
+    size_t pending = pending_tasks;
+    if (pending == 0) {
+        return;
+    }
+    if (pending < elastic.grow_queue_depth) {
+        auto waited = std::chrono::steady_clock::duration(
+            std::chrono::steady_clock::now().time_since_epoch().count() - last_dequeue);
+        if (waited < elastic.grow_wait) {
+            return;
+        }
+    }
+
+    // One thread starts a worker at a time, the others carry on
+    if (scaling.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!stop && live_workers - retire_tokens < elastic.max_threads) {
+            startWorker();
+            ++scale_ups;
+            // Count the new worker's start as progress, so it is not followed by another right away
+            last_dequeue = std::chrono::steady_clock::now().time_since_epoch().count();
+        }
+    }
+    scaling = false;
+}
+
+// Get the number of timers waiting to fire, cancelled ones are not counted
+size_t ThreadPool::getTimerCount() {
+    return timers.liveCount();
+}
+
+// Insert a timer into the wheel and wake a worker to track it if needed
+TimerHandle ThreadPool::addTimer(std::shared_ptr<TimerState> timer) {
+    TimerHandle handle(timer);
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+    if (stop) {
+        throw std::runtime_error("schedule on stopped ThreadPool");
+    }
+
+    timers.add(std::move(timer));
+
+    // The keeper sleeps until its deadline, wake only it if this timer is due earlier
+    if (timer_keeper) {
+        if (timers.nextDeadline() < keeper_deadline && timer_keeper->parked) {
+            parked_workers.erase(std::find(parked_workers.begin(), parked_workers.end(), timer_keeper));
+            timer_keeper->parked = false;
+            timer_keeper->wakeup.notify_one();
+        }
+    } else {
+        unparkWorkers(1);
+    }
+    return handle;
+}
+
+// Block an idle worker; one of them sleeps only until the next timer deadline
+bool ThreadPool::waitForWork(std::unique_lock<std::mutex>& lock) {
+    // Only cancelled entries left: they are dropped once a new timer gets the wheel moving again
+    if (timers.liveCount() == 0 || timer_keeper) {
+        // Elastic workers above the minimum only wait until the idle timeout
+        if (elastic.enabled() && live_workers - retire_tokens > elastic.min_threads) {
+            auto deadline = std::chrono::steady_clock::now() + elastic.idle_timeout;
+            if (!parkWorker(lock, current_slot, deadline)) {
+                current_slot->idle_expired = true;
+            }
+        } else {
+            parkWorker(lock, current_slot, std::chrono::steady_clock::time_point::max());
+        }
+        return false;
+    }
+
+    timer_keeper = current_slot;
+    keeper_deadline = timers.nextDeadline();
+    parkWorker(lock, current_slot, keeper_deadline);
+    timer_keeper = nullptr;
+
+    fireDueTimers();
+    return true;
+}
+
+// Move expired timers to the injection queue, requires queue_mutex
+void ThreadPool::fireDueTimers() {
+    if (timers.empty()) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<TimerState>> expired;
+    timers.advance(std::chrono::steady_clock::now(), expired);
+
+    // A cancelled timer is dropped; a periodic one whose last run is still queued or running skips this run
+    expired.erase(std::remove_if(expired.begin(), expired.end(),
+                                 [](const std::shared_ptr<TimerState>& timer) { return !timer->beginFiring(); }),
+                  expired.end());
+    if (expired.empty()) {
+        return;
+    }
+
+    // Counted before they are published, lock-free consumers do not wait for queue_mutex
+    outstanding_tasks += expired.size();
+    pending_tasks += expired.size();
+    for (auto& timer : expired) {
+        TaskFunction task([firing = TimerFiring(timer)]() mutable { firing.run(); });
+#if THREADPOOL_METRICS
+        task.stamp(detail::metricsNow());
+#endif
+        queues[0]->push(std::move(task), TaskPriority::Normal);
+    }
+
+    unparkWorkers(expired.size());
+}
+
+// Set the handler for exceptions escaping fire-and-forget tasks
+void ThreadPool::setErrorHandler(std::function<void(std::exception_ptr)> handler) {
+    if (!handler) {
+        setErrorHandler(std::function<void(std::exception_ptr, const TaskInfo&)>());
+        return;
+    }
+    setErrorHandler([handler = std::move(handler)](std::exception_ptr error, const TaskInfo&) {
+        handler(error);
+    });
+}
+
+// Same, with what is known about the failed task
+void ThreadPool::setErrorHandler(std::function<void(std::exception_ptr, const TaskInfo&)> handler) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    error_handler = std::move(handler);
+}
+
+// Report an exception that escaped a task
+void ThreadPool::reportError(std::exception_ptr error, const TaskInfo& info) {
+    std::function<void(std::exception_ptr, const TaskInfo&)> handler;
+    {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        handler = error_handler;
+    }
+
+    if (handler) {
+        try {
+            handler(error, info);
+        } catch(...) {
+            // A throwing handler must not take the worker down
+        }
+        return;
+    }
+
+    if (!log_sink || log_level > LogLevel::Error) {
+        return;
+    }
+    std::string what = "unknown exception";
+    try {
+        std::rethrow_exception(error);
+    } catch(const std::exception& e) {
+        what = e.what();
+    } catch(...) {
+    }
+    if (info.name) {
+        what = std::string(info.name) + ": " + what;
+    }
+    int64_t worker = info.worker == TaskInfo::kExternalWorker ? -1 : static_cast<int64_t>(info.worker);
+    log(LogLevel::Error, "Exception occurred in task on worker {}", worker, 0, std::move(what));
+}
+
+// Count the running task as failed and report an exception it caught from work it ran
+void ThreadPool::reportTaskError(std::exception_ptr error) {
+    markTaskFailed();
+    TaskInfo info;
+    info.name = detail::current_task_name;
+    info.worker = current_pool == this ? current_slot->id : TaskInfo::kExternalWorker;
+    info.outcome = TaskOutcome::Failed;
+    reportError(error, info);
+}
+
+// Pass a message to the log sink if its level is enabled
+void ThreadPool::log(LogLevel level, const char* message, int64_t first, int64_t second,
+                     std::string detail) const {
+    if (!log_sink || level < log_level) {
+        return;
+    }
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.message = message;
+    record.values[0] = first;
+    record.values[1] = second;
+    record.detail = std::move(detail);
+    try {
+        log_sink->write(record);
+    } catch(...) {
+        // Logging never fails the pool operation
+    }
+}
+
+// Count the running task as failed although it captured its exception (into a Future)
+void ThreadPool::markTaskFailed() {
+    if (current_task_outcome) {
+        *current_task_outcome = TaskOutcome::Failed;
+    } else {
+        // Inline continuation run outside of any task
+        currentCounters().failed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Count the running task as skipped rather than completed
+void ThreadPool::markTaskSkipped() {
+    if (current_task_outcome) {
+        *current_task_outcome = TaskOutcome::Skipped;
+    } else {
+        currentCounters().skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Why a guarded task must not run, if it must not
+std::optional<TaskCancelled::Reason> ThreadPool::skipReason(const CancellationToken& token,
+                                                           std::chrono::steady_clock::time_point deadline) {
+    if (token.isCancelled()) {
+        return TaskCancelled::Reason::Cancelled;
+    }
+    // Only tasks that have a deadline pay for reading the clock
+    if (deadline != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= deadline) {
+        return TaskCancelled::Reason::DeadlineExpired;
+    }
+    return std::nullopt;
+}
+
+// Queue a task locally when called from a worker, otherwise on the injection queue
+void ThreadPool::submitTask(TaskFunction task, TaskPriority priority, bool reserved) {
+    if (elastic.enabled()) {
+        maybeGrow();
+    }
+
+    // Bounded pool: claim a queue slot first, or apply the overflow policy
+    if (queue_capacity > 0 && !reserved) {
+        if (!admitTask(task)) {
+            return;
+        }
+        reserved = true;
+    }
+
+#if THREADPOOL_METRICS
+    task.stamp(detail::metricsNow());
+#endif
+
+    // Submitted from one of our own workers: keep it local, others can steal it
+    if (current_pool == this && priority == TaskPriority::Normal) {
+        pushLocal(std::move(task), reserved);
+        return;
+    }
+
+    // Lock-free backend: the push needs no lock, wake a worker the way pushLocal() does
+    size_t node = submitNode();
+    if constexpr (InjectionQueue::kLockFree) {
+        if (stop) {
+            if (reserved) {
+                taskDequeued();
+            }
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+
+        ++outstanding_tasks;
+        if (!reserved) {
+            ++pending_tasks;
+        }
+        queues[node]->push(std::move(task), priority);
+        wakeIdleWorkers(1, node);
+        return;
+    }
+
+    WorkerSlot* target = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        // Thread pool has stopped, cannot add tasks
+        if (stop) {
+            lock.unlock();
+            if (reserved) {
+                taskDequeued();
+            }
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+
+        // Add task to the queue, a reserved slot is already counted as pending
+        queues[node]->push(std::move(task), priority);
+        ++outstanding_tasks;
+        if (!reserved) {
+            ++pending_tasks;
+        }
+        target = takeParkedWorker(node);
+    }
+
+    // Wake exactly one parked worker, spinning ones pick the task up on their own
+    if (target) {
+        target->wakeup.notify_one();
+    }
+}
+
+// Task frames of the local deques, taken from the slab heap of the submitting thread
+TaskFunction* ThreadPool::newTaskFrame(TaskFunction task) {
+    TaskFunction* frame = SlabAllocator<TaskFunction>().allocate(1);
+    return ::new (static_cast<void*>(frame)) TaskFunction(std::move(task));
+}
+
+void ThreadPool::deleteTaskFrame(TaskFunction* frame) noexcept {
+    frame->~TaskFunction();
+    SlabAllocator<TaskFunction>().deallocate(frame, 1);
+}
+
+// Queue a task that continues already accepted work (a strand drain, a graph node, a coroutine, a fork)
+void ThreadPool::submitUnbounded(TaskFunction task) {
+    if (queue_capacity > 0) {
+        // Claimed past the capacity, given back by taskDequeued() like any other slot
+        task.markUndroppable();
+        ++pending_tasks;
+        submitTask(std::move(task), TaskPriority::Normal, true);
+        return;
+    }
+    submitTask(std::move(task));
+}
+
+// Queue a batch of tasks with one lock acquisition and targeted wakeups
+void ThreadPool::submitTasks(std::vector<TaskFunction>& batch) {
+    size_t count = batch.size();
+    if (count == 0) {
+        return;
+    }
+    if (elastic.enabled()) {
+        maybeGrow();
+    }
+
+#if THREADPOOL_METRICS
+    uint64_t now = detail::metricsNow();
+    for (auto& task : batch) {
+        task.stamp(now);
+    }
+#endif
+
+    // Bounded pools admit a batch task by task so the overflow policy applies to each
+    if (queue_capacity > 0) {
+        for (auto& task : batch) {
+            submitTask(std::move(task));
+        }
+        return;
+    }
+
+    if (current_pool == this) {
+        if (stop) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        outstanding_tasks += count;
+        pending_tasks += count;
+        for (auto& task : batch) {
+            current_slot->local_tasks.push(newTaskFrame(std::move(task)));
+        }
+        wakeIdleWorkers(count);
+        return;
+    }
+
+    InjectionQueue& queue = *queues[submitNode()];
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+    if (stop) {
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+
+    outstanding_tasks += count;
+    pending_tasks += count;
+    for (auto& task : batch) {
+        queue.push(std::move(task), TaskPriority::Normal);
+    }
+
+    // Wake exactly min(count, parked) workers
+    unparkWorkers(count);
+}
+
+// Wake up to count idle workers after tasks were pushed onto a local deque
+void ThreadPool::wakeIdleWorkers(size_t count, size_t node) {
+    if (idle_threads == 0) {
+        return;
+    }
+
+    // Serialize with workers that are between checking the predicate and parking
+    if (count == 1) {
+        WorkerSlot* target = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            target = takeParkedWorker(node);
+        }
+        if (target) {
+            target->wakeup.notify_one();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    unparkWorkers(count);
+}
+
+// Whether a worker has anything to do, without taking the lock
+bool ThreadPool::hasWork() const {
+    return stop.load(std::memory_order_relaxed) ||
+           (!paused.load(std::memory_order_relaxed) && pending_tasks.load(std::memory_order_relaxed) > 0);
+}
+
+// Poll for work for a bounded time before parking, as configured by the idle policy
+void ThreadPool::spinForWork() {
+    for (size_t i = 0; i < idle_policy.spin_count; ++i) {
+        if (hasWork()) {
+            return;
+        }
+        cpuRelax();
+    }
+    for (size_t i = 0; i < idle_policy.yield_count; ++i) {
+        if (hasWork()) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// Sleep on the worker's own condition variable until unparked or the deadline passes
+bool ThreadPool::parkWorker(std::unique_lock<std::mutex>& lock, WorkerSlot* self,
+                            std::chrono::steady_clock::time_point deadline) {
+    self->parked = true;
+    parked_workers.push_back(self);
+    self->counters.parked.fetch_add(1, std::memory_order_relaxed);
+
+    auto unparked = [self] { return !self->parked; };
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+        self->wakeup.wait(lock, unparked);
+    } else if (!self->wakeup.wait_until(lock, deadline, unparked)) {
+        // Timed out, nobody took this worker off the list
+        parked_workers.erase(std::find(parked_workers.begin(), parked_workers.end(), self));
+        self->parked = false;
+        return false;
+    }
+    return true;
+}
+
+// Take the most recently parked worker off the parked list, null if none
+ThreadPool::WorkerSlot* ThreadPool::takeParkedWorker(size_t node) {
+    if (parked_workers.empty()) {
+        return nullptr;
+    }
+    // LIFO: the last worker to park has the warmest cache, among those of the node if any
+    size_t index = parked_workers.size() - 1;
+    if (queues.size() > 1) {
+        for (size_t i = parked_workers.size(); i-- > 0;) {
+            if (parked_workers[i]->node == node) {
+                index = i;
+                break;
+            }
+        }
+    }
+    WorkerSlot* slot = parked_workers[index];
+    parked_workers.erase(parked_workers.begin() + index);
+    slot->parked = false;
+    return slot;
+}
+
+// Wake up to count parked workers
+void ThreadPool::unparkWorkers(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        WorkerSlot* slot = takeParkedWorker();
+        if (!slot) {
+            return;
+        }
+        slot->wakeup.notify_one();
+    }
+}
+
+// Push a task submitted by one of our workers onto its local deque
+void ThreadPool::pushLocal(TaskFunction task, bool reserved) {
+    if (stop) {
+        if (reserved) {
+            taskDequeued();
+        }
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+
+    // Count the task before publishing it so the counters never underflow
+    ++outstanding_tasks;
+    if (!reserved) {
+        ++pending_tasks;
+    }
+    current_slot->local_tasks.push(newTaskFrame(std::move(task)));
+
+    // Only touch the mutex when somebody is actually sleeping
+    wakeIdleWorkers(1, current_slot->node);
+}
+
+// Claim a queue slot of a bounded pool, fails if capacity tasks are queued
+bool ThreadPool::reserveSlot() {
+    size_t queued = pending_tasks;
+    while (queued < queue_capacity) {
+        if (pending_tasks.compare_exchange_weak(queued, queued + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Account for a task taken off a queue (or a slot given back), waking a producer blocked on a full pool
+void ThreadPool::taskDequeued() {
+    --pending_tasks;
+    if (elastic.enabled()) {
+        last_dequeue.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                           std::memory_order_relaxed);
+    }
+    if (space_waiters > 0) {
+        std::lock_guard<std::mutex> lock(space_mutex);
+        space_available.notify_one();
+    }
+}
+
+// Claim a slot or apply the overflow policy, returns false if the task already ran inline
+bool ThreadPool::admitTask(TaskFunction& task) {
+    if (reserveSlot()) {
+        return true;
+    }
+
+    switch (overflow_policy) {
+    case OverflowPolicy::Reject:
+        ++rejected_tasks;
+        throw std::runtime_error("enqueue on full ThreadPool");
+    case OverflowPolicy::CallerRuns:
+        ++caller_run_tasks;
+        runInline(task);
+        return false;
+    case OverflowPolicy::DropOldest:
+        while (!reserveSlot()) {
+            if (dropOldestTask()) {
+                continue;
+            }
+            // Nothing droppable: a worker may be the one that has to free a slot
+            if (current_pool == this) {
+                ++caller_run_tasks;
+                runInline(task);
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    case OverflowPolicy::Block:
+        break;
+    }
+
+    // A worker waiting for room may be the one that has to make it
+    if (current_pool == this) {
+        ++caller_run_tasks;
+        runInline(task);
+        return false;
+    }
+
+    bool reserved = false;
+    std::unique_lock<std::mutex> lock(space_mutex);
+    // Registered before the slot is retried, taskDequeued() reads it after decrementing
+    ++space_waiters;
+    space_available.wait(lock, [this, &reserved] {
+        reserved = reserveSlot();
+        return reserved || stop;
+    });
+    --space_waiters;
+
+    if (!reserved) {
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+    return true;
+}
+
+// Run a task on the calling thread as if a worker had dequeued it
+void ThreadPool::runInline(TaskFunction& task) {
+    ++outstanding_tasks;
+    ++active_threads;
+    runTask(task);
+}
+
+// Discard the oldest droppable queued task to make room, returns false if none was found
+bool ThreadPool::dropOldestTask() {
+    TaskFunction victim;
+    bool queued = false;
+    std::unique_lock<std::mutex> lock(queue_mutex, std::defer_lock);
+    if constexpr (!InjectionQueue::kLockFree) {
+        lock.lock();
+    }
+    // The lowest priority present in any node group
+    for (size_t level = PriorityTaskQueue::kLevels; level-- > 0 && !queued;) {
+        for (auto& queue : queues) {
+            if (queue->size(static_cast<TaskPriority>(level)) > 0 &&
+                queue->popDroppable(static_cast<TaskPriority>(level), victim)) {
+                queued = true;
+                break;
+            }
+        }
+    }
+    if (lock.owns_lock()) {
+        lock.unlock();
+    }
+
+    if (queued) {
+        --pending_tasks;
+    } else if (stealTask(nullptr, victim)) {
+        // stealTask() counted it as running and freed its slot, accepted work is run instead
+        if (!victim.isDroppable()) {
+            runTask(victim);
+            return true;
+        }
+        --active_threads;
+    } else {
+        return false;
+    }
+
+    ++dropped_tasks;
+    finishTasks(1);
+    // The victim is destroyed here, outside of any lock
+    return true;
+}
+
+// Run one queued task on the calling thread, returns false if none was available
+bool ThreadPool::runPendingTask() {
+    if (stop || paused || pending_tasks == 0) {
+        return false;
+    }
+
+    TaskFunction task;
+    TaskFunction* local = nullptr;
+    if (current_pool == this && current_slot->local_tasks.pop(local)) {
+        ++active_threads;
+        taskDequeued();
+        task = std::move(*local);
+        deleteTaskFrame(local);
+    } else if (!popInjectedTask(task) &&
+               !stealTask(current_pool == this ? current_slot : nullptr, task)) {
+        return false;
+    }
+
+    runTask(task);
+    return true;
+}
+
+// Pop the oldest task from the injection queue
+bool ThreadPool::popInjectedTask(TaskFunction& task) {
+    std::unique_lock<std::mutex> lock(queue_mutex, std::defer_lock);
+    if constexpr (!InjectionQueue::kLockFree) {
+        lock.lock();
+    }
+    if (paused || !popQueued(task, submitNode())) {
+        return false;
+    }
+    ++active_threads;
+    taskDequeued();
+    return true;
+}
+
+// Node group whose queue a task submitted from this thread goes to
+size_t ThreadPool::submitNode() const {
+    if (queues.size() == 1) {
+        return 0;
+    }
+    if (current_pool == this) {
+        return current_slot->node;
+    }
+    // Node-local for external threads too, they are likely to touch the task's data
+    size_t node = topology.nodeIndexOfCpu(CpuTopology::currentCpu());
+    return node < queues.size() ? node : 0;
+}
+
+// Pop from the queue of the given node group, then from the others
+bool ThreadPool::popQueued(TaskFunction& task, size_t node) {
+    for (size_t i = 0; i < queues.size(); ++i) {
+        if (queues[(node + i) % queues.size()]->pop(task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Number of queued tasks of one priority over all node groups
+size_t ThreadPool::queuedTasks(TaskPriority priority) const {
+    size_t count = 0;
+    for (auto& queue : queues) {
+        count += queue->size(priority);
+    }
+    return count;
+}
+
+// Try to steal a task from a random victim's deque, self may be null for external threads
+bool ThreadPool::stealTask(WorkerSlot* self, TaskFunction& task) {
+    const SlotTable* table = slot_table.load(std::memory_order_acquire);
+    size_t count = table->size();
+    if (count == 0 || (self && count < 2)) {
+        return false;
+    }
+
+    // xorshift64 for victim selection
+    static thread_local uint64_t external_rng = 0x2545F4914F6CDD1DULL;
+    uint64_t& state = self ? self->rng_state : external_rng;
+    uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state = x;
+
+    // With NUMA groups, victims of the own node are tried in a first pass
+    bool preferNode = self && queues.size() > 1;
+    size_t start = static_cast<size_t>(x % count);
+    for (size_t i = 0; i < (preferNode ? 2 * count : count); ++i) {
+        WorkerSlot* victim = (*table)[(start + i) % count];
+        if (victim == self || (preferNode && (victim->node == self->node) != (i < count))) {
+            continue;
+        }
+
+        TaskFunction* stolen = nullptr;
+        if (victim->local_tasks.steal(stolen)) {
+            if (self) {
+                self->counters.stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            ++active_threads;
+            taskDequeued();
+            task = std::move(*stolen);
+            deleteTaskFrame(stolen);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run a dequeued task and update the statistics
+void ThreadPool::runTask(TaskFunction& task) {
+    // Work is still piling up behind this task, maybe another worker is needed
+    if (elastic.enabled()) {
+        maybeGrow();
+    }
+
+    WorkerCounters& counters = currentCounters();
+    bool traced = trace_options.enabled() && sampleTrace();
+    uint64_t started = 0;
+    if (THREADPOOL_METRICS || traced) {
+        started = detail::metricsNow();
+    }
+    uint64_t submitted = 0;
+#if THREADPOOL_METRICS
+    submitted = task.submitTime();
+    // Unstamped tasks (run inline by their submitter) never waited in a queue
+    if (submitted != 0) {
+        counters.queue_wait.record(started - submitted);
+    }
+#endif
+
+    // Saved and restored because helping threads run tasks from inside tasks
+    TaskOutcome outcome = TaskOutcome::Completed;
+    TaskOutcome* outer_task_outcome = current_task_outcome;
+    const char* outer_task_name = detail::current_task_name;
+    current_task_outcome = &outcome;
+    detail::current_task_name = nullptr;
+    std::exception_ptr error;
+    try {
+        task();
+    } catch(...) {
+        outcome = TaskOutcome::Failed;
+        error = std::current_exception();
+    }
+    current_task_outcome = outer_task_outcome;
+    const char* name = detail::current_task_name;
+    detail::current_task_name = outer_task_name;
+
+    if (outcome == TaskOutcome::Failed) {
+        counters.failed.fetch_add(1, std::memory_order_relaxed);
+    } else if (outcome == TaskOutcome::Skipped) {
+        counters.skipped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        counters.completed.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t ended = 0;
+    if (THREADPOOL_METRICS || traced) {
+        ended = detail::metricsNow();
+    }
+#if THREADPOOL_METRICS
+    counters.execution.record(ended - started);
+#endif
+    if (traced || error) {
+        TaskInfo info;
+        info.name = name;
+        info.submit_time = submitted;
+        info.start_time = started;
+        info.end_time = ended;
+        info.worker = current_pool == this ? current_slot->id : TaskInfo::kExternalWorker;
+        info.outcome = outcome;
+        if (traced) {
+            recordTrace(info);
+        }
+        if (error) {
+            reportError(error, info);
+        }
+    }
+    --active_threads;   // Decrement active thread count
+    finishTasks(1);
+}
+
+// Counters of the calling thread: its worker slot, or the shared ones of non-workers
+WorkerCounters& ThreadPool::currentCounters() {
+    return current_pool == this ? current_slot->counters : external_counters;
+}
+
+// Whether the next task run by this thread is traced, per TraceOptions::sample_every
+bool ThreadPool::sampleTrace() const {
+    if (trace_countdown > 0) {
+        --trace_countdown;
+        return false;
+    }
+    trace_countdown = trace_options.sample_every - 1;
+    return true;
+}
+
+// Fill in the ID of a task record and buffer it
+void ThreadPool::recordTrace(TaskInfo& info) {
+    // IDs carry the ring (worker ID + 1, 0 for non-workers) in their top bits
+    if (current_pool == this) {
+        info.id = (static_cast<uint64_t>(current_slot->id + 1) << 40) | current_slot->trace->nextSequence();
+        current_slot->trace->push(info);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(external_trace_mutex);
+    info.id = external_trace->nextSequence();
+    external_trace->push(info);
+}
+
+// Retire finished or discarded tasks, waking waitForCompletion() only when it matters
+void ThreadPool::finishTasks(size_t count) {
+    if (count == 0 || outstanding_tasks.fetch_sub(count) != count) {
+        return;
+    }
+    // The last task is gone; only pay for the lock and syscall if somebody waits
+    if (completion_waiters > 0) {
+        std::lock_guard<std::mutex> lock(completion_mutex);
+        waitCondition.notify_all();
+    }
+}
+
+// Worker thread function - with thread ID parameter
+void ThreadPool::workerThread(size_t id) {
+    WorkerSlot* self = (*slot_table.load(std::memory_order_acquire))[id];
+    current_pool = this;
+    current_slot = self;
+
+    // Placement failures (CPU offline, outside our cpuset, not Linux) leave the worker unpinned
+    if (!self->cpus.empty() && CpuTopology::pinCurrentThread(self->cpus)) {
+        ++pinned_threads;
+    }
+
+    while(true) {
+        if(this->stop) {
+            return;
+        }
+
+        TaskFunction task;
+
+        // Own tasks first, newest first for cache locality, unless urgent work is waiting
+        TaskFunction* local = nullptr;
+        if(!this->paused && queuedTasks(TaskPriority::High) == 0 &&
+           self->local_tasks.pop(local)) {
+            ++active_threads;  // Count as active before it leaves the pending count
+            taskDequeued();
+            task = std::move(*local);
+            deleteTaskFrame(local);
+            runTask(task);
+            continue;
+        }
+
+        // Lock-free backend: shared tasks too, unless timers or retirement need the slow path
+        if constexpr (InjectionQueue::kLockFree) {
+            if(!this->paused && this->timers.liveCount() == 0 && this->retire_tokens == 0 &&
+               popQueued(task, self->node)) {
+                ++active_threads;
+                taskDequeued();
+                runTask(task);
+                continue;
+            }
+        }
+
+        // Stay awake for a moment before going through the lock and parking
+        if(!hasWork()) {
+            spinForWork();
+        }
+        
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            
+            // Busy workers pass through here too, so timers fire even without idle workers
+            fireDueTimers();
+
+            // Wait until there is a task, the thread pool stops, or the thread needs to exit
+            ++idle_threads;
+            bool wasKeeper = false;
+            while(!(this->stop ||
+                    (!this->paused && this->pending_tasks > 0) ||
+                    this->retire_tokens > 0 || self->idle_expired)) {
+                wasKeeper = waitForWork(lock);
+            }
+            --idle_threads;
+
+            // Hand timer keeping over to another idle worker
+            if(wasKeeper && this->timers.liveCount() > 0) {
+                unparkWorkers(1);
+            }
+            
+            // First, check if the thread pool has stopped
+            if(this->stop) {
+                return;
+            }
+            
+            // Take a retirement token, or retire after idling unless down to the minimum
+            bool retiring = false;
+            if(this->retire_tokens > 0) {
+                --retire_tokens;
+                retiring = true;
+            } else if(self->idle_expired) {
+                self->idle_expired = false;
+                if(this->live_workers > this->elastic.min_threads) {
+                    ++scale_downs;
+                    retiring = true;
+                }
+            }
+
+            // Check if the current thread needs to terminate
+            if(retiring) {
+                --live_workers;
+
+                // Hand leftover local tasks (possible while paused) to the remaining workers
+                size_t handedOver = 0;
+                while(self->local_tasks.pop(local)) {
+                    this->queues[self->node]->push(std::move(*local), TaskPriority::Normal);
+                    deleteTaskFrame(local);
+                    ++handedOver;
+                }
+                unparkWorkers(handedOver);
+
+                // The reaper joins this thread and frees the slot
+                exited_slots.push_back(self);
+                reaper_wakeup.notify_one();
+                return;
+            }
+            
+            // Then the shared injection queue
+            if(!this->paused && popQueued(task, self->node)) {
+                ++active_threads;
+                taskDequeued();
+            }
+        }
+
+        // Finally, steal from a random victim
+        if(!task && !this->paused && !stealTask(self, task)) {
+            continue;
+        }
+        
+        // Execute the task and handle exceptions
+        if(task) {
+            runTask(task);
+        }
+    }
+}
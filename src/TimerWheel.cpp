@@ -0,0 +1,244 @@
+#include "TimerWheel.h"
+
+namespace {
+
+// Number of trailing zero bits, x must not be zero
+inline unsigned countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline uint64_t rotateRight(uint64_t x, unsigned r) {
+    r &= 63;
+    return r == 0 ? x : (x >> r) | (x << (64 - r));
+}
+
+} // namespace
+
+// Claim an expired timer for a firing task
+bool TimerState::beginFiring() {
+    int expected = Idle;
+    if (!phase.compare_exchange_strong(expected, Firing, std::memory_order_acq_rel)) {
+        return false;
+    }
+    // A one-shot timer stops counting once it is on its way
+    if (period_ticks == 0) {
+        live->fetch_sub(1, std::memory_order_acq_rel);
+    }
+    return true;
+}
+
+// Run the callback of a claimed timer unless cancelled meanwhile, then release the claim
+void TimerState::fire() {
+    struct Release {
+        TimerState* timer;
+        ~Release() { timer->endFiring(); }
+    } release{this};
+
+    if (!isCancelled()) {
+        callback();
+    }
+}
+
+// Give a claimed timer back: periodic ones become Idle, otherwise the callback is dropped
+void TimerState::endFiring() {
+    int expected = Firing;
+    if (period_ticks > 0) {
+        if (phase.compare_exchange_strong(expected, Idle, std::memory_order_acq_rel)) {
+            return;
+        }
+    } else {
+        phase.compare_exchange_strong(expected, Done, std::memory_order_acq_rel);
+    }
+    // Cancelled or done: nothing runs the callback again
+    callback = nullptr;
+}
+
+// Stop the timer; the callback is dropped now, or by the firing task if one is queued or running
+void TimerState::cancel() {
+    int previous = phase.load(std::memory_order_acquire);
+    do {
+        if (previous == Cancelled || previous == Done) {
+            return;
+        }
+    } while (!phase.compare_exchange_weak(previous, Cancelled, std::memory_order_acq_rel));
+
+    // A firing one-shot timer was uncounted when it was claimed
+    if (live && (previous == Idle || period_ticks > 0)) {
+        live->fetch_sub(1, std::memory_order_acq_rel);
+    }
+    if (previous == Idle) {
+        callback = nullptr;
+    }
+}
+
+TimerWheel::TimerWheel(Clock::time_point start) : start(start) {}
+
+// Tick at or after the given point in time
+uint64_t TimerWheel::tickAt(Clock::time_point when) const {
+    if (when <= start) {
+        return 0;
+    }
+    auto elapsed = when - start;
+    return static_cast<uint64_t>((elapsed + kTick - Clock::duration(1)) / kTick);
+}
+
+// Insert a timer, fires no earlier than the next tick
+void TimerWheel::add(std::shared_ptr<TimerState> timer) {
+    if (timer->expiry_tick <= current_tick) {
+        timer->expiry_tick = current_tick + 1;
+    }
+    ++count;
+    timer->live = live;
+    live->fetch_add(1, std::memory_order_acq_rel);
+    place(std::move(timer));
+}
+
+// Put a timer with expiry_tick >= current_tick into its slot
+void TimerWheel::place(std::shared_ptr<TimerState> timer) {
+    uint64_t delta = timer->expiry_tick - current_tick;
+    for (size_t level = 0; level < kLevels; ++level) {
+        size_t shift = kSlotBits * level;
+        if (delta < (uint64_t{1} << (shift + kSlotBits))) {
+            size_t index = (timer->expiry_tick >> shift) & (kSlots - 1);
+            slots[level][index].push_back(std::move(timer));
+            occupied[level] |= uint64_t{1} << index;
+            return;
+        }
+    }
+    overflow.push_back(std::move(timer));
+}
+
+// Redistribute the slots that start at tick boundary
+void TimerWheel::cascade(uint64_t boundary) {
+    // Overflow timers are re-examined whenever the top level advances
+    size_t topShift = kSlotBits * (kLevels - 1);
+    if ((boundary & ((uint64_t{1} << topShift) - 1)) == 0 && !overflow.empty()) {
+        Slot waiting;
+        waiting.swap(overflow);
+        for (auto& timer : waiting) {
+            if (timer->isCancelled()) {
+                --count;
+            } else {
+                place(std::move(timer));
+            }
+        }
+    }
+
+    // Higher levels first so their timers can land in a lower slot visited right after
+    for (size_t level = kLevels - 1; level >= 1; --level) {
+        size_t shift = kSlotBits * level;
+        if ((boundary & ((uint64_t{1} << shift) - 1)) != 0) {
+            continue;
+        }
+
+        size_t index = (boundary >> shift) & (kSlots - 1);
+        if ((occupied[level] & (uint64_t{1} << index)) == 0) {
+            continue;
+        }
+
+        Slot moving;
+        moving.swap(slots[level][index]);
+        occupied[level] &= ~(uint64_t{1} << index);
+        for (auto& timer : moving) {
+            if (timer->isCancelled()) {
+                --count;
+            } else {
+                place(std::move(timer));
+            }
+        }
+    }
+}
+
+// Advance to now, appending timers that expired (periodic ones are re-armed)
+void TimerWheel::advance(Clock::time_point now, std::vector<std::shared_ptr<TimerState>>& expired) {
+    uint64_t target = now <= start ? 0 : static_cast<uint64_t>((now - start) / kTick);
+
+    while (current_tick < target) {
+        if (count == 0) {
+            current_tick = target;
+            break;
+        }
+
+        uint64_t next = current_tick + 1;
+        if ((next & (kSlots - 1)) != 0) {
+            // Jump over empty level 0 slots up to the next cascade boundary
+            uint64_t boundary = (next | (kSlots - 1)) + 1;
+            uint64_t bits = occupied[0] >> (next & (kSlots - 1));
+            uint64_t due = bits ? next + countTrailingZeros(bits) : boundary;
+            if (due > target) {
+                current_tick = target;
+                break;
+            }
+            next = due;
+        }
+
+        current_tick = next;
+        if ((next & (kSlots - 1)) == 0) {
+            cascade(next);
+        }
+
+        size_t index = next & (kSlots - 1);
+        if ((occupied[0] & (uint64_t{1} << index)) == 0) {
+            continue;
+        }
+
+        Slot due;
+        due.swap(slots[0][index]);
+        occupied[0] &= ~(uint64_t{1} << index);
+        for (auto& timer : due) {
+            --count;
+            if (timer->isCancelled()) {
+                continue;
+            }
+            expired.push_back(timer);
+
+            // Fixed-rate re-arm, skipping periods that were missed entirely
+            if (timer->period_ticks > 0) {
+                timer->expiry_tick += timer->period_ticks;
+                if (timer->expiry_tick <= current_tick) {
+                    timer->expiry_tick = current_tick + 1;
+                }
+                ++count;
+                place(std::move(timer));
+            }
+        }
+    }
+}
+
+// Tick at which the next occupied slot of a level has to be visited
+uint64_t TimerWheel::nextOccupiedTick(size_t level) const {
+    size_t shift = kSlotBits * level;
+    uint64_t block = current_tick >> shift;
+    uint64_t rotated = rotateRight(occupied[level], static_cast<unsigned>((block + 1) & (kSlots - 1)));
+    return (block + 1 + countTrailingZeros(rotated)) << shift;
+}
+
+// Earliest point at which advance() has work to do, time_point::max() if empty
+TimerWheel::Clock::time_point TimerWheel::nextDeadline() const {
+    if (count == 0) {
+        return Clock::time_point::max();
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (size_t level = 0; level < kLevels; ++level) {
+        if (occupied[level] != 0) {
+            uint64_t tick = nextOccupiedTick(level);
+            best = tick < best ? tick : best;
+        }
+    }
+    if (!overflow.empty()) {
+        size_t topShift = kSlotBits * (kLevels - 1);
+        uint64_t tick = ((current_tick >> topShift) + 1) << topShift;
+        best = tick < best ? tick : best;
+    }
+    return start + best * kTick;
+}
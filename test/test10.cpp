@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include "ParallelAlgorithms.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 10 Test (Parallel Algorithms) ===" << std::endl;
+
+    try {
+        ThreadPool pool(4);
+        const size_t size = 1000000;
+
+        std::cout << "\n--- Testing parallelFor ---" << std::endl;
+        std::vector<int> values(size, 0);
+        parallelFor(pool, size_t{0}, size, [&values](size_t i) {
+            values[i] = static_cast<int>(i % 1000);
+        });
+        long long expected = 0;
+        for (size_t i = 0; i < size; ++i) {
+            expected += static_cast<long long>(i % 1000);
+        }
+        std::cout << "Every index visited once: "
+                  << (std::accumulate(values.begin(), values.end(), 0LL) == expected ? "Yes" : "No") << std::endl;
+        if (std::accumulate(values.begin(), values.end(), 0LL) != expected) {
+            throw std::runtime_error("parallelFor verification failed!");
+        }
+
+        std::cout << "\n--- Testing parallelReduce ---" << std::endl;
+        std::vector<long long> numbers(size);
+        std::iota(numbers.begin(), numbers.end(), 1LL);
+        long long sum = parallelReduce(pool, numbers.begin(), numbers.end(), 0LL);
+        std::cout << "Sum of 1.." << size << ": " << sum << std::endl;
+        if (sum != static_cast<long long>(size) * (size + 1) / 2) {
+            throw std::runtime_error("parallelReduce verification failed!");
+        }
+
+        // Accumulated in the type of init: the total overflows int
+        std::vector<int> large(size, 3000);
+        long long wideSum = parallelReduce(pool, large.begin(), large.end(), 0LL);
+        std::cout << "Sum of " << size << " x 3000 ints into long long: " << wideSum << std::endl;
+        if (wideSum != static_cast<long long>(size) * 3000) {
+            throw std::runtime_error("parallelReduce did not accumulate in the init type!");
+        }
+
+        std::cout << "\n--- Testing parallelTransform ---" << std::endl;
+        std::vector<long long> squares(size);
+        parallelTransform(pool, numbers.begin(), numbers.end(), squares.begin(),
+                          [](long long x) { return x * x; });
+        if (squares.front() != 1 || squares.back() != static_cast<long long>(size) * size) {
+            throw std::runtime_error("parallelTransform verification failed!");
+        }
+        std::cout << "Last square: " << squares.back() << std::endl;
+
+        std::cout << "\n--- Testing parallelSort ---" << std::endl;
+        std::mt19937 gen(42);
+        std::vector<int> data(size);
+        for (auto& x : data) {
+            x = static_cast<int>(gen());
+        }
+        std::vector<int> reference = data;
+        std::sort(reference.begin(), reference.end());
+        parallelSort(pool, data.begin(), data.end());
+        std::cout << "Sorted correctly: " << (data == reference ? "Yes" : "No") << std::endl;
+        if (data != reference) {
+            throw std::runtime_error("parallelSort verification failed!");
+        }
+
+        std::cout << "\n--- Testing Nested Use From Pool Tasks ---" << std::endl;
+        auto nested = pool.enqueue([&pool] {
+            std::vector<int> inner(10000, 1);
+            return parallelReduce(pool, inner.begin(), inner.end(), 0);
+        });
+        std::cout << "Nested reduce result: " << nested.get() << std::endl;
+
+        std::cout << "\n--- Testing Exception Propagation ---" << std::endl;
+        try {
+            parallelFor(pool, 0, 1000, 10, [](int i) {
+                if (i == 777) {
+                    throw std::runtime_error("Index 777 failed");
+                }
+            });
+            throw std::logic_error("parallelFor swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+
+        std::cout << "\n--- Testing A Cleared Right Half ---" << std::endl;
+        {
+            ThreadPool paused(2);
+            paused.pause();
+            bool rightRan = false;
+            try {
+                // The left half clears the queued right half before any worker can take it
+                parallelInvoke(paused, [&paused] { paused.clearTasks(); }, [&rightRan] { rightRan = true; });
+                throw std::logic_error("parallelInvoke ignored the cleared right half!");
+            } catch (const std::future_error& e) {
+                std::cout << "Caught: " << e.what() << ", right half ran: " << (rightRan ? "Yes" : "No") << std::endl;
+                if (e.code() != std::future_errc::broken_promise || rightRan) {
+                    throw std::runtime_error("Cleared right half reported the wrong error!");
+                }
+            }
+            paused.resume();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 10 Test Completed ===" << std::endl;
+    return 0;
+}
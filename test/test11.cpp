@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <string>
+#include "ThreadPool.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 11 Test (Task Priorities) ===" << std::endl;
+
+    try {
+        // A single worker makes the execution order deterministic
+        ThreadPool pool(1);
+        pool.setPriorityAging(4);
+
+        std::mutex orderMutex;
+        std::vector<char> order;
+        auto record = [&orderMutex, &order](char tag) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(tag);
+        };
+
+        std::cout << "\n--- Queueing Tasks While Paused ---" << std::endl;
+        pool.pause();
+        std::vector<std::future<void>> results;
+        for (int i = 0; i < 10; ++i) {
+            results.push_back(pool.enqueue(TaskPriority::Low, record, 'L'));
+        }
+        for (int i = 0; i < 5; ++i) {
+            results.push_back(pool.enqueue(record, 'N'));
+        }
+        for (int i = 0; i < 20; ++i) {
+            results.push_back(pool.enqueue(TaskPriority::High, record, 'H'));
+        }
+
+        std::cout << "Queued high/normal/low: " << pool.getTaskCount(TaskPriority::High) << "/"
+                  << pool.getTaskCount(TaskPriority::Normal) << "/"
+                  << pool.getTaskCount(TaskPriority::Low) << std::endl;
+        if (pool.getTaskCount(TaskPriority::High) != 20 || pool.getTaskCount(TaskPriority::Normal) != 5 ||
+            pool.getTaskCount(TaskPriority::Low) != 10 || pool.getTaskCount() != 35) {
+            throw std::runtime_error("Per-priority queue depths are wrong!");
+        }
+
+        pool.resume();
+        for (auto& result : results) {
+            result.get();
+        }
+
+        std::string sequence(order.begin(), order.end());
+        std::cout << "Execution order: " << sequence << std::endl;
+
+        std::cout << "\n--- Verifying Priority Order And Aging ---" << std::endl;
+        if (sequence.front() != 'H') {
+            throw std::runtime_error("High priority task did not run first!");
+        }
+        size_t firstLow = sequence.find('L');
+        size_t firstNormal = sequence.find('N');
+        std::cout << "First normal task at position " << firstNormal << ", first low task at position " << firstLow << std::endl;
+        // With an aging limit of 4 both lower levels get a turn after four high priority tasks
+        if (firstNormal > 5 || firstLow > 5) {
+            throw std::runtime_error("Lower priority tasks starved despite aging!");
+        }
+        if (sequence.substr(0, 4) != "HHHH") {
+            throw std::runtime_error("Lower priority tasks overtook high priority tasks too early!");
+        }
+        std::cout << "All queues drained: " << (pool.getTaskCount() == 0 ? "Yes" : "No") << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 11 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+using namespace std::chrono;
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 12 Test (Timers) ===" << std::endl;
+
+    try {
+        ThreadPool pool(2);
+
+        std::cout << "\n--- Testing scheduleAfter ---" << std::endl;
+        std::atomic<bool> fired{false};
+        auto scheduled = steady_clock::now();
+        std::atomic<long long> delayMs{0};
+        pool.scheduleAfter(milliseconds(100), [&] {
+            delayMs = duration_cast<milliseconds>(steady_clock::now() - scheduled).count();
+            fired = true;
+        });
+        std::this_thread::sleep_for(milliseconds(300));
+        std::cout << "Timer fired: " << (fired ? "Yes" : "No") << " after " << delayMs << " ms" << std::endl;
+        if (!fired || delayMs < 100) {
+            throw std::runtime_error("Delayed task did not fire on time!");
+        }
+
+        std::cout << "\n--- Testing Cancellation ---" << std::endl;
+        std::atomic<bool> cancelledRan{false};
+        TimerHandle handle = pool.scheduleAfter(milliseconds(50), [&] { cancelledRan = true; });
+        handle.cancel();
+        std::this_thread::sleep_for(milliseconds(150));
+        std::cout << "Cancelled timer ran: " << (cancelledRan ? "Yes" : "No") << std::endl;
+        if (cancelledRan) {
+            throw std::runtime_error("Cancelled timer still ran!");
+        }
+
+        std::cout << "\n--- Testing scheduleEvery ---" << std::endl;
+        std::atomic<int> ticks{0};
+        TimerHandle periodic = pool.scheduleEvery(milliseconds(20), [&] { ++ticks; });
+        std::this_thread::sleep_for(milliseconds(250));
+        periodic.cancel();
+        int ticksAtCancel = ticks;
+        std::this_thread::sleep_for(milliseconds(100));
+        std::cout << "Periodic runs: " << ticksAtCancel << ", after cancel: " << ticks << std::endl;
+        if (ticksAtCancel < 5 || ticks > ticksAtCancel + 1) {
+            throw std::runtime_error("Periodic timer misbehaved!");
+        }
+
+        std::cout << "\n--- Testing Periodic Runs Do Not Overlap ---" << std::endl;
+        std::atomic<int> inside{0};
+        std::atomic<int> overlapped{0};
+        std::atomic<int> slowRuns{0};
+        TimerHandle slow = pool.scheduleEvery(milliseconds(5), [&] {
+            if (++inside > 1) {
+                ++overlapped;
+            }
+            std::this_thread::sleep_for(milliseconds(30));
+            ++slowRuns;
+            --inside;
+        });
+        std::this_thread::sleep_for(milliseconds(250));
+        slow.cancel();
+        std::this_thread::sleep_for(milliseconds(50));
+        std::cout << "Runs of a 30 ms callback every 5 ms: " << slowRuns << ", overlapping: " << overlapped << std::endl;
+        if (overlapped != 0 || slowRuns == 0 || slowRuns > 9) {
+            throw std::runtime_error("Periodic timer runs overlapped!");
+        }
+
+        std::cout << "\n--- Testing scheduleAt From A Worker ---" << std::endl;
+        std::atomic<bool> nestedFired{false};
+        pool.enqueue([&pool, &nestedFired] {
+            pool.scheduleAt(steady_clock::now() + milliseconds(30), [&nestedFired] { nestedFired = true; });
+        }).get();
+        std::this_thread::sleep_for(milliseconds(150));
+        if (!nestedFired) {
+            throw std::runtime_error("Timer scheduled from a worker did not fire!");
+        }
+        std::cout << "Nested timer fired: Yes" << std::endl;
+
+        std::cout << "\n--- Testing Many Pending Timers ---" << std::endl;
+        const int count = 200000;
+        std::vector<TimerHandle> handles;
+        handles.reserve(count);
+        std::atomic<int> longRan{0};
+        auto start = steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            // Minutes out, so none can fire before it is cancelled, and spread to exercise every wheel level
+            handles.push_back(pool.scheduleAfter(minutes(5) + milliseconds(i * 7), [&longRan] { ++longRan; }));
+        }
+        auto inserted = steady_clock::now();
+        size_t pending = pool.getTimerCount();
+        for (auto& h : handles) {
+            h.cancel();
+        }
+        auto cancelled = steady_clock::now();
+        std::cout << "Inserted " << count << " timers in " << duration_cast<milliseconds>(inserted - start).count()
+                  << " ms, cancelled in " << duration_cast<milliseconds>(cancelled - inserted).count() << " ms" << std::endl;
+        std::cout << "Timers pending before/after cancelling: " << pending << "/" << pool.getTimerCount() << std::endl;
+        if (pending != static_cast<size_t>(count) || pool.getTimerCount() != 0) {
+            throw std::runtime_error("Cancelled timers still counted!");
+        }
+
+        std::cout << "\n--- Testing Cancel Releases The Callback ---" << std::endl;
+        auto resource = std::make_shared<int>(42);
+        std::weak_ptr<int> watched = resource;
+        TimerHandle holding = pool.scheduleAfter(minutes(5), [resource] { (void)resource; });
+        TimerHandle holdingPeriodic = pool.scheduleEvery(minutes(5), [resource] { (void)resource; });
+        resource.reset();
+        holding.cancel();
+        holdingPeriodic.cancel();
+        std::cout << "Captured state released on cancel: " << (watched.expired() ? "Yes" : "No") << std::endl;
+        if (!watched.expired()) {
+            throw std::runtime_error("Cancelled timer kept its callback alive!");
+        }
+
+        std::cout << "\n--- Testing Timer Exceptions ---" << std::endl;
+        std::atomic<int> handled{0};
+        pool.setErrorHandler([&handled](std::exception_ptr) { ++handled; });
+        pool.scheduleAfter(milliseconds(10), [] { throw std::runtime_error("Timer callback failed"); });
+        std::this_thread::sleep_for(milliseconds(100));
+        std::cout << "Timer exceptions handled: " << handled << std::endl;
+        if (handled != 1 || longRan != 0) {
+            throw std::runtime_error("Timer exception handling failed!");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 12 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include <future>
+#include "TaskGraph.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 13 Test (Task Graphs) ===" << std::endl;
+
+    try {
+        // A small pool on purpose: blocking on futures inside tasks would deadlock here
+        ThreadPool pool(2);
+
+        std::cout << "\n--- Testing Dependency Order ---" << std::endl;
+        std::mutex orderMutex;
+        std::string order;
+        auto record = [&orderMutex, &order](char tag) {
+            return [&orderMutex, &order, tag] {
+                std::lock_guard<std::mutex> lock(orderMutex);
+                order += tag;
+            };
+        };
+
+        // Diamond: A runs first, B and C in parallel, D last
+        TaskGraph graph;
+        auto a = graph.emplace(record('A'));
+        auto b = graph.emplace(record('B'));
+        auto c = graph.emplace(record('C'));
+        auto d = graph.emplace(record('D'));
+        a.precede(b).precede(c);
+        d.succeed(b).succeed(c);
+
+        graph.run(pool).get();
+        std::cout << "Execution order: " << order << std::endl;
+        if (order.size() != 4 || order.front() != 'A' || order.back() != 'D') {
+            throw std::runtime_error("Dependencies were not respected!");
+        }
+
+        std::cout << "\n--- Testing Graph Reuse ---" << std::endl;
+        for (int i = 0; i < 100; ++i) {
+            order.clear();
+            graph.run(pool).get();
+            if (order.size() != 4 || order.front() != 'A' || order.back() != 'D') {
+                throw std::runtime_error("Re-run of the graph broke the order!");
+            }
+        }
+        std::cout << "Graph re-run 100 times successfully" << std::endl;
+
+        std::cout << "\n--- Testing A Wide And Deep Graph ---" << std::endl;
+        TaskGraph layered;
+        std::atomic<int> executed{0};
+        const int width = 50;
+        const int depth = 20;
+        std::vector<TaskGraph::Node> previous;
+        for (int level = 0; level < depth; ++level) {
+            std::vector<TaskGraph::Node> current;
+            for (int i = 0; i < width; ++i) {
+                auto node = layered.emplace([&executed] { ++executed; });
+                if (!previous.empty()) {
+                    node.succeed(previous[i]).succeed(previous[(i + 1) % width]);
+                }
+                current.push_back(node);
+            }
+            previous = current;
+        }
+        layered.run(pool).get();
+        std::cout << "Nodes executed: " << executed << " of " << layered.size() << std::endl;
+        if (executed != width * depth) {
+            throw std::runtime_error("Not every node of the layered graph ran!");
+        }
+
+        std::cout << "\n--- Testing Exception Propagation ---" << std::endl;
+        TaskGraph failing;
+        std::atomic<bool> afterFailureRan{false};
+        auto bad = failing.emplace([] { throw std::runtime_error("Node failed"); });
+        auto after = failing.emplace([&afterFailureRan] { afterFailureRan = true; });
+        bad.precede(after);
+        try {
+            failing.run(pool).get();
+            throw std::logic_error("Graph swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught: " << e.what() << ", dependent node ran: " << (afterFailureRan ? "Yes" : "No") << std::endl;
+        }
+        if (afterFailureRan) {
+            throw std::runtime_error("Dependent node ran after its predecessor failed!");
+        }
+
+        std::cout << "\n--- Testing A Full Rejecting Pool ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.capacity = 1;
+            options.overflow = OverflowPolicy::Reject;
+            ThreadPool bounded(2, options);
+            TaskGraph fanOut;
+            std::atomic<int> ran{0};
+            auto source = fanOut.emplace([&ran] { ++ran; });
+            auto sink = fanOut.emplace([&ran] { ++ran; });
+            for (int i = 0; i < 64; ++i) {
+                fanOut.emplace([&ran] { ++ran; }).succeed(source).precede(sink);
+            }
+
+            // The queue is full before the graph starts, its nodes must still be accepted
+            bounded.pause();
+            bounded.post([] {});
+            auto done = fanOut.run(bounded);
+            bounded.resume();
+            done.get();
+            std::cout << "Nodes run on a full Reject pool: " << ran << " of " << fanOut.size()
+                      << ", rejected: " << bounded.getRejectedTaskCount() << std::endl;
+            if (ran != static_cast<int>(fanOut.size()) || bounded.getRejectedTaskCount() != 0) {
+                throw std::runtime_error("Graph nodes were refused by the bounded pool!");
+            }
+        }
+
+        std::cout << "\n--- Testing Cleared Nodes ---" << std::endl;
+        {
+            ThreadPool paused(2);
+            TaskGraph chain;
+            std::atomic<int> ran{0};
+            auto head = chain.emplace([&ran] { ++ran; });
+            auto tail = chain.emplace([&ran] { ++ran; });
+            head.precede(tail);
+
+            paused.pause();
+            auto cleared = chain.run(paused);
+            paused.clearTasks();
+            paused.resume();
+            bool broken = false;
+            try {
+                cleared.get();
+            } catch (const std::future_error& e) {
+                broken = e.code() == std::future_errc::broken_promise;
+            }
+            // The run is over, so the graph can run again
+            chain.run(paused).get();
+            std::cout << "Cleared run failed with broken_promise: " << (broken ? "Yes" : "No")
+                      << ", nodes run over both runs: " << ran << std::endl;
+            if (!broken || ran != 2) {
+                throw std::runtime_error("Cleared graph node was not settled!");
+            }
+        }
+
+        std::cout << "\n--- Testing Cycle Detection ---" << std::endl;
+        TaskGraph cyclic;
+        auto x = cyclic.emplace([] {});
+        auto y = cyclic.emplace([] {});
+        x.precede(y);
+        y.precede(x);
+        try {
+            cyclic.run(pool);
+            throw std::runtime_error("Cycle was not detected!");
+        } catch (const std::logic_error& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 13 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <future>
+#include "Future.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 14 Test (Composable Futures) ===" << std::endl;
+
+    try {
+        ThreadPool pool(2);
+
+        std::cout << "\n--- Testing async() And then() ---" << std::endl;
+        auto chained = pool.async([](int x) { return x * 2; }, 21)
+            .then([](int x) { return std::to_string(x); })
+            .then([](std::string s) { return s + "!"; });
+        std::string text = chained.get();
+        std::cout << "Chained result: " << text << std::endl;
+        if (text != "42!") {
+            throw std::runtime_error("Continuation chain produced a wrong value!");
+        }
+
+        std::atomic<int> sideEffect{0};
+        pool.async([&sideEffect] { sideEffect = 1; })
+            .then([&sideEffect] { sideEffect = sideEffect * 10; })
+            .get();
+        std::cout << "Void chain side effect: " << sideEffect << std::endl;
+        if (sideEffect != 10) {
+            throw std::runtime_error("Void continuations ran out of order!");
+        }
+
+        std::cout << "\n--- Testing Inline Continuations ---" << std::endl;
+        // Hold the producer back until the continuation is attached
+        std::promise<void> attached;
+        std::shared_future<void> attachedGate = attached.get_future().share();
+        std::thread::id producer;
+        std::thread::id consumer;
+        auto inlineDone = pool.async([&producer, attachedGate] {
+                attachedGate.wait();
+                producer = std::this_thread::get_id();
+            })
+            .then(Continuation::Inline, [&consumer] { consumer = std::this_thread::get_id(); });
+        attached.set_value();
+        inlineDone.get();
+        std::cout << "Inline continuation ran on the producing thread: " << (producer == consumer ? "Yes" : "No") << std::endl;
+        if (producer != consumer) {
+            throw std::runtime_error("Inline continuation was rescheduled!");
+        }
+
+        std::cout << "\n--- Testing Nested Futures ---" << std::endl;
+        int nested = pool.async([] { return 5; })
+            .then([&pool](int x) { return pool.async([x] { return x + 1; }); })
+            .get();
+        std::cout << "Flattened nested future: " << nested << std::endl;
+        if (nested != 6) {
+            throw std::runtime_error("Nested future was not flattened!");
+        }
+
+        std::cout << "\n--- Testing Exception Propagation ---" << std::endl;
+        size_t failedBefore = pool.getFailedTaskCount();
+        std::atomic<bool> skippedRan{false};
+        auto failing = pool.async([] { return 1; })
+            .then([](int) -> int { throw std::runtime_error("Stage failed"); })
+            .then([&skippedRan](int x) { skippedRan = true; return x; });
+        try {
+            failing.get();
+            throw std::logic_error("Exception was swallowed!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+        pool.waitForCompletion();
+        size_t failedNow = pool.getFailedTaskCount() - failedBefore;
+        std::cout << "Downstream continuation ran: " << (skippedRan ? "Yes" : "No")
+                  << ", failed tasks counted: " << failedNow << std::endl;
+        if (skippedRan || failedNow != 1) {
+            throw std::runtime_error("Failure was not propagated or counted correctly!");
+        }
+
+        std::cout << "\n--- Testing whenAll() ---" << std::endl;
+        std::vector<Future<int>> squares;
+        for (int i = 0; i < 100; ++i) {
+            squares.push_back(pool.async([i] { return i * i; }));
+        }
+        auto sum = whenAll(std::move(squares)).then([](std::vector<int> values) {
+            long total = 0;
+            for (int v : values) {
+                total += v;
+            }
+            return total;
+        }).get();
+        std::cout << "Sum of squares: " << sum << std::endl;
+        if (sum != 328350) {
+            throw std::runtime_error("whenAll lost values!");
+        }
+
+        auto mixed = whenAll(pool.async([] { return 7; }),
+                             pool.async([] {}),
+                             pool.async([] { return std::string("seven"); })).get();
+        std::cout << "Mixed results: " << std::get<0>(mixed) << ", " << std::get<2>(mixed) << std::endl;
+        if (std::get<0>(mixed) != 7 || std::get<2>(mixed) != "seven") {
+            throw std::runtime_error("Heterogeneous whenAll returned wrong values!");
+        }
+
+        std::vector<Future<void>> voids;
+        voids.push_back(pool.async([] {}));
+        voids.push_back(pool.async([] { throw std::runtime_error("One of many failed"); }));
+        try {
+            whenAll(std::move(voids)).get();
+            throw std::logic_error("whenAll swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+
+        std::cout << "\n--- Testing whenAny() ---" << std::endl;
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        std::vector<Future<int>> racers;
+        racers.push_back(pool.async([gate] { gate.wait(); return 1; }));
+        racers.push_back(pool.async([] { return 2; }));
+        auto first = whenAny(std::move(racers)).get();
+        int winner = first.future.get();
+        release.set_value();
+        std::cout << "First completed: index " << first.index << ", value " << winner << std::endl;
+        if (first.index != 1 || winner != 2) {
+            throw std::runtime_error("whenAny picked the wrong future!");
+        }
+
+        std::cout << "\n--- Testing Long Chains On One Worker ---" << std::endl;
+        // Every stage would deadlock a single worker if continuations blocked on get()
+        pool.waitForCompletion();
+        pool.resize(1);
+        auto counter = pool.async([] { return 0; });
+        for (int i = 0; i < 1000; ++i) {
+            counter = counter.then([](int x) { return x + 1; });
+        }
+        int stages = counter.get();
+        std::cout << "Stages completed: " << stages << std::endl;
+        if (stages != 1000) {
+            throw std::runtime_error("Long continuation chain did not complete!");
+        }
+
+        std::cout << "\n--- Testing Cleared Tasks Break The Promise ---" << std::endl;
+        {
+            ThreadPool paused(2);
+            auto isBroken = [](auto& future) {
+                try {
+                    future.get();
+                } catch (const std::future_error& e) {
+                    return e.code() == std::future_errc::broken_promise;
+                }
+                return false;
+            };
+
+            paused.pause();
+            auto cleared = paused.async([] { return 1; });
+            auto chained = paused.async([] { return 2; }).then([](int x) { return x + 1; });
+            paused.clearTasks();
+            paused.resume();
+            bool clearedBroken = isBroken(cleared);
+            bool chainedBroken = isBroken(chained);
+
+            // A continuation cleared while it is queued breaks the promise of its own future
+            std::promise<void> gate;
+            std::shared_future<void> opened = gate.get_future().share();
+            auto first = paused.async([opened] { opened.wait(); return 3; });
+            while (paused.getActiveThreadCount() == 0) {
+                std::this_thread::yield();
+            }
+            paused.pause();
+            auto continued = first.then([](int x) { return x * 2; });
+            gate.set_value();
+            while (paused.getTaskCount() == 0) {
+                std::this_thread::yield();
+            }
+            paused.clearTasks();
+            paused.resume();
+            bool continuationBroken = isBroken(continued);
+
+            std::cout << "Broken promise for a cleared task: " << (clearedBroken ? "Yes" : "No")
+                      << ", after it in a chain: " << (chainedBroken ? "Yes" : "No")
+                      << ", for a cleared continuation: " << (continuationBroken ? "Yes" : "No") << std::endl;
+            if (!clearedBroken || !chainedBroken || !continuationBroken) {
+                throw std::runtime_error("Cleared task left its future hanging!");
+            }
+        }
+
+        std::cout << "\n--- Testing Continuations On A Full Rejecting Pool ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.capacity = 1;
+            options.overflow = OverflowPolicy::Reject;
+            ThreadPool bounded(1, options);
+            std::promise<void> gate;
+            std::shared_future<void> opened = gate.get_future().share();
+            auto chained = bounded.async([opened] { opened.wait(); return 20; })
+                .then([](int x) { return x + 1; })
+                .then([](int x) { return x * 2; });
+            // The queue is full by the time the first continuation is posted
+            while (bounded.getActiveThreadCount() == 0) {
+                std::this_thread::yield();
+            }
+            bounded.post([] {});
+            gate.set_value();
+            int value = chained.get();
+            std::cout << "Chain result: " << value << ", rejected: " << bounded.getRejectedTaskCount() << std::endl;
+            if (value != 42 || bounded.getRejectedTaskCount() != 0) {
+                throw std::runtime_error("Continuation refused by the bounded pool!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 14 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "Coroutine.h"
+
+// Hop onto the pool and compute a value there
+Task<int> computeOnPool(ThreadPool& pool, int value, std::thread::id caller, std::atomic<bool>& movedToPool) {
+    co_await pool.schedule();
+    if (std::this_thread::get_id() != caller) {
+        movedToPool = true;
+    }
+    co_return value * 2;
+}
+
+// Await other tasks without blocking any thread
+Task<std::string> combine(ThreadPool& pool, std::thread::id caller, std::atomic<bool>& movedToPool) {
+    int a = co_await computeOnPool(pool, 10, caller, movedToPool);
+    int b = co_await computeOnPool(pool, 11, caller, movedToPool);
+    co_return std::to_string(a + b);
+}
+
+Task<> failOnPool(ThreadPool& pool) {
+    co_await pool.schedule();
+    throw std::runtime_error("Coroutine failed");
+}
+
+Task<int> catchFailure(ThreadPool& pool) {
+    try {
+        co_await failOnPool(pool);
+    } catch (const std::runtime_error&) {
+        co_return 1;
+    }
+    co_return 0;
+}
+
+Task<int> immediate(int value) {
+    co_return value;
+}
+
+// Many synchronously completing awaits in a row
+Task<long> longChain(ThreadPool& pool, int length) {
+    co_await pool.schedule();
+    long total = 0;
+    for (int i = 0; i < length; ++i) {
+        total += co_await immediate(1);
+    }
+    co_return total;
+}
+
+// Only hop onto the pool
+Task<> hop(ThreadPool& pool) {
+    co_await pool.schedule();
+}
+
+// Suspend many coroutines on the pool at once
+Task<> fanOut(ThreadPool& pool, std::atomic<int>& resumed) {
+    co_await pool.schedule();
+    ++resumed;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 15 Test (Coroutines) ===" << std::endl;
+
+    try {
+        ThreadPool pool(2);
+
+        std::cout << "\n--- Testing schedule() And Task<T> ---" << std::endl;
+        std::atomic<bool> movedToPool{false};
+        std::string combined = syncWait(combine(pool, std::this_thread::get_id(), movedToPool));
+        std::cout << "Combined result: " << combined << ", resumed on a worker: " << (movedToPool ? "Yes" : "No") << std::endl;
+        if (combined != "42" || !movedToPool) {
+            throw std::runtime_error("Coroutine did not run on the pool or produced a wrong value!");
+        }
+
+        std::cout << "\n--- Testing schedule() On A Full Bounded Pool ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.capacity = 1;
+            options.overflow = OverflowPolicy::CallerRuns;
+            ThreadPool bounded(1, options);
+            bounded.pause();
+            bounded.post([] {});
+            std::thread resumer([&bounded] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                bounded.resume();
+            });
+            std::atomic<bool> movedFromFull{false};
+            int doubled = syncWait(computeOnPool(bounded, 21, std::this_thread::get_id(), movedFromFull));
+            resumer.join();
+            std::cout << "Result: " << doubled << ", resumed on a worker: " << (movedFromFull ? "Yes" : "No")
+                      << ", caller runs: " << bounded.getCallerRunTaskCount() << std::endl;
+            if (doubled != 42 || !movedFromFull || bounded.getCallerRunTaskCount() != 0) {
+                throw std::runtime_error("schedule() ran the coroutine on the caller of a full pool!");
+            }
+        }
+
+        std::cout << "\n--- Testing A Cleared Resumption ---" << std::endl;
+        {
+            ThreadPool paused(1);
+            paused.pause();
+            bool broken = false;
+            std::thread waiter([&paused, &broken] {
+                try {
+                    syncWait(hop(paused));
+                } catch (const std::future_error& e) {
+                    broken = e.code() == std::future_errc::broken_promise;
+                }
+            });
+            while (paused.getTaskCount() == 0) {
+                std::this_thread::yield();
+            }
+            paused.clearTasks();
+            waiter.join();
+            paused.resume();
+            std::cout << "syncWait returned with broken_promise: " << (broken ? "Yes" : "No") << std::endl;
+            if (!broken) {
+                throw std::runtime_error("Cleared resumption left the coroutine suspended!");
+            }
+        }
+
+        std::cout << "\n--- Testing Exception Propagation ---" << std::endl;
+        int caught = syncWait(catchFailure(pool));
+        std::cout << "Exception caught inside the coroutine: " << (caught ? "Yes" : "No") << std::endl;
+        if (!caught) {
+            throw std::runtime_error("Exception was not rethrown by co_await!");
+        }
+        try {
+            syncWait(failOnPool(pool));
+            throw std::logic_error("syncWait swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught from syncWait: " << e.what() << std::endl;
+        }
+
+        std::cout << "\n--- Testing Long Await Chains ---" << std::endl;
+        long total = syncWait(longChain(pool, 10000));
+        std::cout << "Chain length completed: " << total << std::endl;
+        if (total != 10000) {
+            throw std::runtime_error("Long await chain did not complete!");
+        }
+
+        std::cout << "\n--- Testing Many Coroutines ---" << std::endl;
+        std::atomic<int> resumed{0};
+        std::vector<Task<>> tasks;
+        for (int i = 0; i < 1000; ++i) {
+            tasks.push_back(fanOut(pool, resumed));
+        }
+        for (auto& task : tasks) {
+            syncWait(std::move(task));
+        }
+        std::cout << "Coroutines resumed on the pool: " << resumed << std::endl;
+        if (resumed != 1000) {
+            throw std::runtime_error("Not every coroutine was resumed!");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 15 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include "ThreadPool.h"
+
+// Run the same workload under one idle policy
+void exercisePolicy(const char* name, const IdlePolicy& policy) {
+    std::cout << "\n--- Testing Idle Policy: " << name << " ---" << std::endl;
+    ThreadPoolOptions options;
+    options.idle = policy;
+    ThreadPool pool(4, options);
+
+    // Sparse submissions: workers go idle (spin, yield or park) between tasks
+    std::atomic<int> sparse{0};
+    for (int i = 0; i < 50; ++i) {
+        pool.enqueue([&sparse] { ++sparse; }).get();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::cout << "Sparse tasks completed: " << sparse << std::endl;
+    if (sparse != 50) {
+        throw std::runtime_error("Sparse tasks were lost!");
+    }
+
+    // Bursts, including tasks submitted from inside workers
+    std::atomic<int> burst{0};
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 200; ++i) {
+        results.push_back(pool.enqueue([&pool, &burst] {
+            ++burst;
+            pool.post([&burst] { ++burst; });
+        }));
+    }
+    for (auto& result : results) {
+        result.get();
+    }
+    pool.waitForCompletion();
+    std::cout << "Burst tasks completed: " << burst << std::endl;
+    if (burst != 400) {
+        throw std::runtime_error("Burst tasks were lost!");
+    }
+
+    // Parked workers must wake up for resume, timers and shrinking
+    pool.pause();
+    std::atomic<int> afterResume{0};
+    for (int i = 0; i < 10; ++i) {
+        pool.post([&afterResume] { ++afterResume; });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pool.resume();
+    pool.waitForCompletion();
+
+    std::promise<void> fired;
+    pool.scheduleAfter(std::chrono::milliseconds(5), [&fired] { fired.set_value(); });
+    if (fired.get_future().wait_for(std::chrono::seconds(2)) != std::future_status::ready) {
+        throw std::runtime_error("Timer did not wake a parked worker!");
+    }
+
+    pool.resize(1);
+    pool.enqueue([] {}).get();
+    std::cout << "Tasks after resume: " << afterResume << ", timer fired, shrunk to " << pool.getThreadCount() << std::endl;
+    if (afterResume != 10) {
+        throw std::runtime_error("Tasks queued while paused were lost!");
+    }
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 16 Test (Idle Policies) ===" << std::endl;
+
+    try {
+        exercisePolicy("park", IdlePolicy::park());
+        exercisePolicy("spin then park", IdlePolicy::spinThenPark());
+        exercisePolicy("yield then park", IdlePolicy::spinThenPark(0, 1000));
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 16 Test Completed ===" << std::endl;
+    return 0;
+}
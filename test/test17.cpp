@@ -0,0 +1,161 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include "TaskGroup.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 17 Test (Completion Tracking) ===" << std::endl;
+
+    try {
+        ThreadPool pool(4);
+
+        std::cout << "\n--- Testing waitForCompletion Under Load ---" << std::endl;
+        std::atomic<int> counter{0};
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                pool.post([&counter, &pool, i] {
+                    ++counter;
+                    // Tasks spawned by tasks must be waited for too
+                    if (i % 10 == 0) {
+                        pool.post([&counter] { ++counter; });
+                    }
+                });
+            }
+            pool.waitForCompletion();
+            if (counter != (round + 1) * 1100) {
+                throw std::runtime_error("waitForCompletion returned with tasks outstanding!");
+            }
+        }
+        std::cout << "Tasks completed over 20 rounds: " << counter << std::endl;
+
+        std::cout << "\n--- Testing Concurrent Waiters ---" << std::endl;
+        std::atomic<int> slow{0};
+        for (int i = 0; i < 8; ++i) {
+            pool.post([&slow] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++slow;
+            });
+        }
+        std::vector<std::thread> waiters;
+        std::atomic<int> released{0};
+        for (int i = 0; i < 3; ++i) {
+            waiters.emplace_back([&pool, &slow, &released] {
+                pool.waitForCompletion();
+                if (slow == 8) {
+                    ++released;
+                }
+            });
+        }
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+        std::cout << "Waiters released after all tasks: " << released << std::endl;
+        if (released != 3) {
+            throw std::runtime_error("A waiter was released early or not at all!");
+        }
+
+        std::cout << "\n--- Testing TaskGroup Scope ---" << std::endl;
+        // An unrelated long task must not hold up the group
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        std::promise<void> started;
+        pool.post([gate, &started] {
+            started.set_value();
+            gate.wait();
+        });
+        // Make sure a worker owns it, group.wait() must not help with it from this thread
+        started.get_future().wait();
+
+        std::atomic<int> grouped{0};
+        auto start = std::chrono::steady_clock::now();
+        {
+            TaskGroup group(pool);
+            for (int i = 0; i < 100; ++i) {
+                group.run([&grouped] { ++grouped; });
+            }
+            auto squared = group.enqueue([](int x) { return x * x; }, 12);
+            group.wait();
+            std::cout << "Group tasks completed: " << grouped << ", enqueue result: " << squared.get() << std::endl;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << "Pool still busy with the unrelated task: " << (pool.getActiveThreadCount() > 0 ? "Yes" : "No") << std::endl;
+        release.set_value();
+        if (grouped != 100 || elapsed > std::chrono::seconds(5)) {
+            throw std::runtime_error("TaskGroup waited for the wrong tasks!");
+        }
+
+        std::cout << "\n--- Testing Nested TaskGroup On One Worker ---" << std::endl;
+        pool.waitForCompletion();
+        pool.resize(1);
+        auto nested = pool.enqueue([&pool] {
+            std::atomic<int> inner{0};
+            TaskGroup group(pool);
+            for (int i = 0; i < 10; ++i) {
+                group.run([&inner] { ++inner; });
+            }
+            // The only worker helps instead of deadlocking
+            group.wait();
+            return inner.load();
+        });
+        int innerCount = nested.get();
+        std::cout << "Inner group tasks completed: " << innerCount << std::endl;
+        if (innerCount != 10) {
+            throw std::runtime_error("Nested group did not complete!");
+        }
+
+        std::cout << "\n--- Testing TaskGroup Exceptions ---" << std::endl;
+        size_t failedBefore = pool.getFailedTaskCount();
+        TaskGroup failing(pool);
+        failing.run([] { throw std::runtime_error("Group task failed"); });
+        failing.run([] {});
+        try {
+            failing.wait();
+            throw std::logic_error("TaskGroup swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+        pool.waitForCompletion();
+        std::cout << "Failed tasks counted: " << pool.getFailedTaskCount() - failedBefore << std::endl;
+        if (pool.getFailedTaskCount() - failedBefore != 1) {
+            throw std::runtime_error("Group failure was not counted!");
+        }
+
+        std::cout << "\n--- Testing Cleared TaskGroup Tasks ---" << std::endl;
+        {
+            ThreadPool paused(2);
+            TaskGroup group(paused);
+            paused.pause();
+            group.run([] {});
+            auto result = group.enqueue([] { return 1; });
+            paused.clearTasks();
+            paused.resume();
+            bool groupBroken = false;
+            bool futureBroken = false;
+            try {
+                group.wait();
+            } catch (const std::future_error& e) {
+                groupBroken = e.code() == std::future_errc::broken_promise;
+            }
+            try {
+                result.get();
+            } catch (const std::future_error& e) {
+                futureBroken = e.code() == std::future_errc::broken_promise;
+            }
+            std::cout << "wait() returned with broken_promise: " << (groupBroken ? "Yes" : "No")
+                      << ", enqueue() future broken: " << (futureBroken ? "Yes" : "No")
+                      << ", tasks left: " << group.getTaskCount() << std::endl;
+            if (!groupBroken || !futureBroken || group.getTaskCount() != 0) {
+                throw std::runtime_error("Cleared group tasks were not settled!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 17 Test Completed ===" << std::endl;
+    return 0;
+}
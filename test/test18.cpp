@@ -0,0 +1,219 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <memory>
+#include "ThreadPool.h"
+#include "Future.h"
+#include "ParallelAlgorithms.h"
+#include "TaskGraph.h"
+
+// Options for a pool that holds at most capacity queued tasks
+ThreadPoolOptions bounded(size_t capacity, OverflowPolicy overflow) {
+    ThreadPoolOptions options;
+    options.capacity = capacity;
+    options.overflow = overflow;
+    return options;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 18 Test (Bounded Queue) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Reject And tryEnqueue ---" << std::endl;
+        {
+            ThreadPool pool(1, bounded(4, OverflowPolicy::Reject));
+            pool.pause();
+            std::vector<std::future<int>> accepted;
+            for (int i = 0; i < 4; ++i) {
+                auto result = pool.tryEnqueue([i] { return i; });
+                if (!result) {
+                    throw std::runtime_error("tryEnqueue failed below capacity!");
+                }
+                accepted.push_back(std::move(*result));
+            }
+            bool tryFailed = !pool.tryEnqueue([] { return 0; });
+            bool postFailed = !pool.tryPost([] {});
+            bool threw = false;
+            try {
+                pool.enqueue([] {});
+            } catch (const std::runtime_error& e) {
+                threw = true;
+                std::cout << "Caught: " << e.what() << std::endl;
+            }
+            pool.resume();
+            int sum = 0;
+            for (auto& result : accepted) {
+                sum += result.get();
+            }
+            std::cout << "Accepted sum: " << sum << ", rejected: " << pool.getRejectedTaskCount() << std::endl;
+            if (!tryFailed || !postFailed || !threw || sum != 6 || pool.getRejectedTaskCount() != 3) {
+                throw std::runtime_error("Reject policy misbehaved!");
+            }
+        }
+
+        std::cout << "\n--- Testing CallerRuns ---" << std::endl;
+        {
+            ThreadPool pool(1, bounded(2, OverflowPolicy::CallerRuns));
+            pool.pause();
+            pool.post([] {});
+            pool.post([] {});
+            std::thread::id ranOn;
+            auto inlineResult = pool.enqueue([&ranOn] { ranOn = std::this_thread::get_id(); return 7; });
+            // Ran on this thread before enqueue() returned, although the pool is paused
+            std::cout << "Overflow task ran on the caller: " << (ranOn == std::this_thread::get_id() ? "Yes" : "No")
+                      << ", result: " << inlineResult.get() << std::endl;
+            pool.resume();
+            pool.waitForCompletion();
+            if (ranOn != std::this_thread::get_id() || pool.getCallerRunTaskCount() != 1) {
+                throw std::runtime_error("CallerRuns policy misbehaved!");
+            }
+        }
+
+        std::cout << "\n--- Testing DropOldest ---" << std::endl;
+        {
+            ThreadPool pool(1, bounded(3, OverflowPolicy::DropOldest));
+            pool.pause();
+            std::vector<std::future<int>> results;
+            for (int i = 0; i < 5; ++i) {
+                results.push_back(pool.enqueue([i] { return i; }));
+            }
+            pool.resume();
+            int dropped = 0;
+            std::vector<int> kept;
+            for (auto& result : results) {
+                try {
+                    kept.push_back(result.get());
+                } catch (const std::future_error&) {
+                    ++dropped;
+                }
+            }
+            std::cout << "Kept:";
+            for (int value : kept) {
+                std::cout << " " << value;
+            }
+            std::cout << ", dropped: " << dropped << " (counted " << pool.getDroppedTaskCount() << ")" << std::endl;
+            if (dropped != 2 || kept != std::vector<int>{2, 3, 4} || pool.getDroppedTaskCount() != 2) {
+                throw std::runtime_error("DropOldest did not discard the oldest tasks!");
+            }
+        }
+
+        std::cout << "\n--- Testing DropOldest Under A Flood ---" << std::endl;
+        {
+            // Graph nodes, parallel halves and continuations continue accepted work and are never dropped
+            ThreadPool pool(2, bounded(2, OverflowPolicy::DropOldest));
+            std::atomic<bool> flooding{true};
+            std::thread producer([&pool, &flooding] {
+                while (flooding) {
+                    pool.post([] {});
+                }
+            });
+
+            std::atomic<int> visited{0};
+            parallelFor(pool, 0, 2000, [&visited](int) { ++visited; });
+
+            TaskGraph graph;
+            std::atomic<int> nodesRun{0};
+            std::vector<TaskGraph::Node> chains;
+            for (int i = 0; i < 64; ++i) {
+                auto node = graph.emplace([&nodesRun] { ++nodesRun; });
+                if (i >= 8) {
+                    chains[i - 8].precede(node);
+                }
+                chains.push_back(node);
+            }
+            graph.run(pool).get();
+
+            // The head of the chain is an ordinary task and may be dropped, its continuations not
+            int chained = -1;
+            while (chained < 0) {
+                auto headRan = std::make_shared<std::atomic<bool>>(false);
+                auto chain = pool.async([headRan] { *headRan = true; return 0; });
+                for (int i = 0; i < 16; ++i) {
+                    chain = chain.then([](int x) { return x + 1; });
+                }
+                try {
+                    chained = chain.get();
+                } catch (const std::future_error&) {
+                    if (*headRan) {
+                        throw std::runtime_error("DropOldest dropped a continuation!");
+                    }
+                }
+            }
+
+            flooding = false;
+            producer.join();
+            pool.waitForCompletion();
+            std::cout << "Indices visited: " << visited << ", graph nodes run: " << nodesRun
+                      << ", chain result: " << chained << ", dropped: " << pool.getDroppedTaskCount() << std::endl;
+            if (visited != 2000 || nodesRun != 64 || chained != 16) {
+                throw std::runtime_error("DropOldest lost accepted work!");
+            }
+        }
+
+        std::cout << "\n--- Testing Block ---" << std::endl;
+        {
+            ThreadPool pool(2, bounded(8, OverflowPolicy::Block));
+            std::atomic<int> done{0};
+            std::atomic<size_t> maxQueued{0};
+            std::vector<std::thread> producers;
+            for (int p = 0; p < 4; ++p) {
+                producers.emplace_back([&pool, &done, &maxQueued] {
+                    for (int i = 0; i < 500; ++i) {
+                        pool.post([&done] { ++done; });
+                        size_t queued = pool.getTaskCount();
+                        size_t seen = maxQueued;
+                        while (queued > seen && !maxQueued.compare_exchange_weak(seen, queued)) {
+                        }
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            pool.waitForCompletion();
+            std::cout << "Tasks completed: " << done << ", max queued: " << maxQueued << std::endl;
+            if (done != 2000 || maxQueued > 8) {
+                throw std::runtime_error("Block policy exceeded the capacity or lost tasks!");
+            }
+
+            // A producer blocked on a paused, full pool is released by resume()
+            pool.pause();
+            for (int i = 0; i < 8; ++i) {
+                pool.post([] {});
+            }
+            std::atomic<bool> unblocked{false};
+            std::thread blocked([&pool, &unblocked] {
+                pool.post([] {});
+                unblocked = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            bool waited = !unblocked;
+            pool.resume();
+            blocked.join();
+            std::cout << "Producer waited while full: " << (waited ? "Yes" : "No") << std::endl;
+            if (!waited) {
+                throw std::runtime_error("Producer was not blocked by a full pool!");
+            }
+
+            // Workers never block on their own pool, the overflow runs inline
+            auto nested = pool.enqueue([&pool] {
+                for (int i = 0; i < 100; ++i) {
+                    pool.post([] {});
+                }
+                return true;
+            });
+            nested.get();
+            pool.waitForCompletion();
+            std::cout << "Nested submissions beyond capacity completed" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 18 Test Completed ===" << std::endl;
+    return 0;
+}
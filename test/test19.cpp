@@ -0,0 +1,157 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <numeric>
+#include "ThreadPool.h"
+#include "MpmcRingQueue.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 19 Test (Lock-Free Queue) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing MPMC Ring Capacity ---" << std::endl;
+        {
+            MpmcRingQueue<int> ring(5);
+            std::cout << "Requested 5, capacity " << ring.capacity() << std::endl;
+            if (ring.capacity() != 8) {
+                throw std::runtime_error("Capacity not rounded up to a power of two!");
+            }
+            for (int i = 0; i < 8; ++i) {
+                int value = i;
+                if (!ring.tryPush(std::move(value))) {
+                    throw std::runtime_error("tryPush failed below capacity!");
+                }
+            }
+            int extra = 42;
+            if (ring.tryPush(std::move(extra)) || extra != 42) {
+                throw std::runtime_error("Full ring accepted or consumed an item!");
+            }
+            for (int expected = 0; expected < 8; ++expected) {
+                int value = -1;
+                if (!ring.tryPop(value) || value != expected) {
+                    throw std::runtime_error("Ring is not FIFO!");
+                }
+            }
+            int value = 0;
+            if (ring.tryPop(value) || !ring.empty()) {
+                throw std::runtime_error("Empty ring returned an item!");
+            }
+            std::cout << "Full and empty ring behave correctly" << std::endl;
+        }
+
+        std::cout << "\n--- Testing MPMC Ring With Concurrent Producers And Consumers ---" << std::endl;
+        {
+            const int producers = 4;
+            const int consumers = 4;
+            const int perProducer = 50000;
+            MpmcRingQueue<int> ring(64);
+            std::atomic<long long> sum{0};
+            std::atomic<int> consumed{0};
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&ring, p] {
+                    for (int i = 1; i <= perProducer; ++i) {
+                        int value = p * perProducer + i;
+                        while (!ring.tryPush(std::move(value))) {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (int c = 0; c < consumers; ++c) {
+                threads.emplace_back([&] {
+                    int value = 0;
+                    while (consumed < producers * perProducer) {
+                        if (ring.tryPop(value)) {
+                            sum += value;
+                            ++consumed;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            long long total = static_cast<long long>(producers) * perProducer;
+            long long expected = total * (total + 1) / 2;
+            std::cout << "Consumed " << consumed << " items, sum " << sum << " (expected " << expected << ")" << std::endl;
+            if (sum != expected || consumed != producers * perProducer) {
+                throw std::runtime_error("Items lost or duplicated!");
+            }
+        }
+
+        std::cout << "\n--- Testing Lock-Free Priority Queue Spill ---" << std::endl;
+        {
+            LockFreePriorityTaskQueue queue;
+            const int count = static_cast<int>(LockFreePriorityTaskQueue::kRingCapacity) * 3;
+            std::vector<int> order;
+            for (int i = 0; i < count; ++i) {
+                queue.push(TaskFunction([&order, i] { order.push_back(i); }), TaskPriority::Normal);
+            }
+            queue.push(TaskFunction([&order] { order.push_back(-1); }), TaskPriority::High);
+            std::cout << "Queued " << queue.size() << " tasks" << std::endl;
+            if (queue.size() != static_cast<size_t>(count) + 1 || queue.size(TaskPriority::High) != 1) {
+                throw std::runtime_error("Wrong queue size!");
+            }
+
+            TaskFunction task;
+            while (queue.pop(task)) {
+                task();
+            }
+            bool fifo = order.size() == static_cast<size_t>(count) + 1 && order.front() == -1;
+            for (int i = 0; fifo && i < count; ++i) {
+                fifo = order[i + 1] == i;
+            }
+            std::cout << "High priority first, normal tasks in order: " << (fifo ? "Yes" : "No") << std::endl;
+            if (!fifo || !queue.empty()) {
+                throw std::runtime_error("Spilled tasks came out of order!");
+            }
+
+            for (int i = 0; i < 10; ++i) {
+                queue.push(TaskFunction([] {}), TaskPriority::Low);
+            }
+            if (queue.clear() != 10 || !queue.empty()) {
+                throw std::runtime_error("clear() returned the wrong count!");
+            }
+        }
+
+        std::cout << "\n--- Testing Pool With Compiled Queue Backend ---" << std::endl;
+        {
+            std::cout << "Backend: " << (InjectionQueue::kLockFree ? "lock-free" : "mutex") << std::endl;
+            ThreadPool pool(4);
+            const int producers = 4;
+            const int perProducer = 5000;
+            std::atomic<int> executed{0};
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&pool, &executed] {
+                    for (int i = 0; i < perProducer; ++i) {
+                        pool.post([&executed] { ++executed; });
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto timed = std::make_shared<std::promise<void>>();
+            auto fired = timed->get_future();
+            pool.scheduleAfter(std::chrono::milliseconds(5), [timed] { timed->set_value(); });
+            pool.waitForCompletion();
+            fired.wait();
+            std::cout << "Executed " << executed << " tasks, timer fired" << std::endl;
+            if (executed != producers * perProducer) {
+                throw std::runtime_error("Pool lost tasks!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 19 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <fstream>
+#include <filesystem>
+#include <future>
+#include <set>
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+// Fake sysfs node directory with the given cpulist files
+fs::path makeFakeTopology(const std::vector<std::string>& cpulists) {
+    fs::path root = fs::temp_directory_path() / "threadpool_test_topology";
+    fs::remove_all(root);
+    for (size_t node = 0; node < cpulists.size(); ++node) {
+        fs::path dir = root / ("node" + std::to_string(node));
+        fs::create_directories(dir);
+        std::ofstream(dir / "cpulist") << cpulists[node] << "\n";
+    }
+    // Entries that are not nodes must be ignored
+    fs::create_directories(root / "power");
+    std::ofstream(root / "possible") << "0-" << cpulists.size() - 1 << "\n";
+    return root;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 20 Test (CPU Affinity And NUMA) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing CPU List Parsing ---" << std::endl;
+        {
+            std::vector<int> cpus = CpuTopology::parseCpuList("0-3,8,10-11\n");
+            std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+            std::cout << "Parsed " << cpus.size() << " CPUs" << std::endl;
+            if (cpus != expected || !CpuTopology::parseCpuList("").empty() ||
+                !CpuTopology::parseCpuList("3-1").empty() || !CpuTopology::parseCpuList("1,x").empty()) {
+                throw std::runtime_error("CPU list parsed incorrectly!");
+            }
+        }
+
+        std::cout << "\n--- Testing Topology Detection ---" << std::endl;
+        {
+            CpuTopology machine = CpuTopology::detect();
+            std::cout << "This machine has " << machine.nodeCount() << " NUMA node(s)" << std::endl;
+            if (machine.nodeCount() == 0 || machine.nodes()[0].cpus.empty()) {
+                throw std::runtime_error("Detected topology is empty!");
+            }
+
+            CpuTopology missing = CpuTopology::detect("/nonexistent/threadpool/nodes");
+            if (missing.nodeCount() != 1) {
+                throw std::runtime_error("Missing sysfs did not fall back to a single node!");
+            }
+
+            fs::path root = makeFakeTopology({"0-1", "2-3"});
+            CpuTopology fake = CpuTopology::detect(root.string());
+            fs::remove_all(root);
+            std::cout << "Fake topology: " << fake.nodeCount() << " nodes, CPU 3 on node index "
+                      << fake.nodeIndexOfCpu(3) << std::endl;
+            if (fake.nodeCount() != 2 || fake.nodeIndexOfCpu(1) != 0 || fake.nodeIndexOfCpu(3) != 1 ||
+                fake.nodeIndexOfCpu(99) != 0) {
+                throw std::runtime_error("Fake topology read incorrectly!");
+            }
+        }
+
+        std::cout << "\n--- Testing Worker Pinning ---" << std::endl;
+        {
+            int cpu = CpuTopology::currentCpu();
+            if (cpu < 0) {
+                std::cout << "CPU placement not supported here, skipping" << std::endl;
+            } else {
+                ThreadPoolOptions options;
+                options.cpus = {cpu};
+                ThreadPool pool(2, options);
+                std::vector<std::future<int>> results;
+                for (int i = 0; i < 20; ++i) {
+                    results.push_back(pool.enqueue([] { return CpuTopology::currentCpu(); }));
+                }
+                std::set<int> seen;
+                for (auto& result : results) {
+                    seen.insert(result.get());
+                }
+                std::cout << "Pinned workers: " << pool.getPinnedThreadCount()
+                          << ", tasks ran on " << seen.size() << " CPU(s)" << std::endl;
+                if (pool.getPinnedThreadCount() == 2 && (seen.size() != 1 || *seen.begin() != cpu)) {
+                    throw std::runtime_error("Pinned workers ran on another CPU!");
+                }
+            }
+        }
+
+        std::cout << "\n--- Testing NUMA Groups On A Two-Node Topology ---" << std::endl;
+        {
+            // CPUs that may not exist here: pinning fails and the pool must still work
+            ThreadPoolOptions options;
+            options.numa_aware = true;
+            options.topology = CpuTopology({NumaNode{0, {0}}, NumaNode{1, {4096}}});
+            ThreadPool pool(4, options);
+            std::cout << "Node groups: " << pool.getNodeCount() << std::endl;
+            if (pool.getNodeCount() != 2) {
+                throw std::runtime_error("Expected two node groups!");
+            }
+
+            std::atomic<int> executed{0};
+            for (int i = 0; i < 1000; ++i) {
+                pool.post([&executed] { ++executed; });
+            }
+            // Nested submissions stay on the worker's node group
+            auto nested = pool.enqueue([&pool, &executed] {
+                for (int i = 0; i < 100; ++i) {
+                    pool.post([&executed] { ++executed; });
+                }
+            });
+            nested.get();
+            pool.waitForCompletion();
+            std::cout << "Executed " << executed << " tasks" << std::endl;
+            if (executed != 1100) {
+                throw std::runtime_error("NUMA pool lost tasks!");
+            }
+
+            pool.pause();
+            pool.enqueue(TaskPriority::High, [] {});
+            pool.enqueue(TaskPriority::Low, [] {});
+            size_t high = pool.getTaskCount(TaskPriority::High);
+            pool.clearTasks();
+            pool.resume();
+            if (high != 1 || pool.getTaskCount() != 0) {
+                throw std::runtime_error("Per-node queues miscounted!");
+            }
+        }
+
+        std::cout << "\n--- Testing NUMA Mode On The Real Machine ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.numa_aware = true;
+            ThreadPool pool(2, options);
+            auto result = pool.enqueue([] { return 42; });
+            std::cout << "Node groups: " << pool.getNodeCount() << ", result: " << result.get() << std::endl;
+            if (pool.getNodeCount() != CpuTopology::detect().nodeCount()) {
+                throw std::runtime_error("Node groups do not match the machine!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 20 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include "ThreadPool.h"
+
+// Options for an elastic pool between min and max workers
+ThreadPoolOptions elasticOptions(size_t minThreads, size_t maxThreads) {
+    ThreadPoolOptions options;
+    options.elastic.min_threads = minThreads;
+    options.elastic.max_threads = maxThreads;
+    options.elastic.grow_queue_depth = 4;
+    options.elastic.idle_timeout = std::chrono::milliseconds(50);
+    return options;
+}
+
+// Poll until the pool has the given number of workers or the timeout passes
+bool waitForThreadCount(ThreadPool& pool, size_t count, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (pool.getThreadCount() != count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return pool.getThreadCount() == count;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 21 Test (Elastic Scaling) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Growth Under A Deep Queue ---" << std::endl;
+        ThreadPool pool(1, elasticOptions(1, 4));
+        {
+            std::atomic<int> executed{0};
+            for (int i = 0; i < 60; ++i) {
+                pool.post([&executed] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    ++executed;
+                });
+            }
+            pool.waitForCompletion();
+            std::cout << "Executed " << executed << " tasks, peak threads " << pool.getPeakThreadCount()
+                      << ", scale-ups " << pool.getScaleUpCount() << std::endl;
+            if (executed != 60 || pool.getPeakThreadCount() < 2 || pool.getPeakThreadCount() > 4 ||
+                pool.getScaleUpCount() == 0) {
+                throw std::runtime_error("Elastic pool did not grow under load!");
+            }
+        }
+
+        std::cout << "\n--- Testing Retirement After Idle Timeout ---" << std::endl;
+        {
+            bool shrunk = waitForThreadCount(pool, 1, std::chrono::seconds(5));
+            std::cout << "Threads after idling: " << pool.getThreadCount()
+                      << ", scale-downs " << pool.getScaleDownCount() << std::endl;
+            if (!shrunk || pool.getScaleDownCount() == 0) {
+                throw std::runtime_error("Idle workers were not retired!");
+            }
+            // Never below the minimum, however long it idles
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+            if (pool.getThreadCount() != 1) {
+                throw std::runtime_error("Pool shrank below min_threads!");
+            }
+        }
+
+        std::cout << "\n--- Testing Growth Again On Reused Worker IDs ---" << std::endl;
+        {
+            size_t scaleUps = pool.getScaleUpCount();
+            std::vector<std::future<int>> results;
+            for (int i = 0; i < 40; ++i) {
+                results.push_back(pool.enqueue([i] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    return i;
+                }));
+            }
+            int sum = 0;
+            for (auto& result : results) {
+                sum += result.get();
+            }
+            std::cout << "Sum " << sum << ", scale-ups " << pool.getScaleUpCount()
+                      << ", threads " << pool.getThreadCount() << std::endl;
+            if (sum != 780 || pool.getScaleUpCount() == scaleUps || pool.getThreadCount() > 4) {
+                throw std::runtime_error("Pool did not grow again after shrinking!");
+            }
+        }
+
+        std::cout << "\n--- Testing Growth On Queue Wait Time ---" << std::endl;
+        {
+            ThreadPoolOptions options = elasticOptions(1, 2);
+            options.elastic.grow_queue_depth = 1000;
+            options.elastic.grow_wait = std::chrono::milliseconds(2);
+            ThreadPool waitPool(1, options);
+
+            std::promise<void> release;
+            std::shared_future<void> gate = release.get_future().share();
+            std::promise<void> started;
+            auto blocker = waitPool.enqueue([gate, &started] {
+                started.set_value();
+                gate.wait();
+            });
+            started.get_future().wait();
+
+            // Queued behind the blocked worker; the next submission sees it waiting too long
+            auto stuck = waitPool.enqueue([] { return 1; });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            auto trigger = waitPool.enqueue([] { return 2; });
+
+            bool ranWhileBlocked = stuck.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+            release.set_value();
+            blocker.get();
+            std::cout << "Queued task ran while the only worker was blocked: " << (ranWhileBlocked ? "Yes" : "No")
+                      << ", threads " << waitPool.getThreadCount() << std::endl;
+            if (!ranWhileBlocked || stuck.get() + trigger.get() != 3 || waitPool.getScaleUpCount() != 1) {
+                throw std::runtime_error("Pool did not grow on queue wait time!");
+            }
+        }
+
+        std::cout << "\n--- Testing Manual Resize Of An Elastic Pool ---" << std::endl;
+        {
+            pool.resize(3);
+            size_t grown = pool.getThreadCount();
+            pool.resize(1);
+            std::cout << "Resized to " << grown << " then " << pool.getThreadCount() << std::endl;
+            auto result = pool.enqueue([] { return 5; });
+            if (grown != 3 || pool.getThreadCount() != 1 || result.get() != 5) {
+                throw std::runtime_error("Manual resize misbehaved!");
+            }
+        }
+
+        std::cout << "\n--- Testing Invalid Bounds ---" << std::endl;
+        {
+            bool threw = false;
+            try {
+                ThreadPool invalid(1, elasticOptions(4, 2));
+            } catch (const std::invalid_argument& e) {
+                threw = true;
+                std::cout << "Caught: " << e.what() << std::endl;
+            }
+            if (!threw) {
+                throw std::runtime_error("min_threads > max_threads was accepted!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 21 Test Completed ===" << std::endl;
+    return 0;
+}
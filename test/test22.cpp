@@ -0,0 +1,114 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include "ThreadPool.h"
+
+// Occupy count workers until the returned promise is fulfilled
+std::promise<void> blockWorkers(ThreadPool& pool, int count, std::atomic<int>& started) {
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    for (int i = 0; i < count; ++i) {
+        pool.post([gate, &started] {
+            ++started;
+            gate.wait();
+        });
+    }
+    while (started < count) {
+        std::this_thread::yield();
+    }
+    return release;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 22 Test (Non-Blocking Resize) ===" << std::endl;
+
+    try {
+        ThreadPool pool(4);
+
+        std::cout << "\n--- Testing Shrink Does Not Wait For Busy Workers ---" << std::endl;
+        {
+            std::atomic<int> started{0};
+            std::promise<void> release = blockWorkers(pool, 4, started);
+
+            auto begin = std::chrono::steady_clock::now();
+            std::future<void> shrunk = pool.resize(1);
+            auto elapsed = std::chrono::steady_clock::now() - begin;
+            bool readyEarly = shrunk.wait_for(std::chrono::milliseconds(20)) == std::future_status::ready;
+            std::cout << "resize(1) returned after "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+                      << " us, thread count " << pool.getThreadCount()
+                      << ", completed while busy: " << (readyEarly ? "Yes" : "No") << std::endl;
+            if (readyEarly || pool.getThreadCount() != 1 || elapsed > std::chrono::seconds(1)) {
+                throw std::runtime_error("Shrinking blocked or completed too early!");
+            }
+
+            release.set_value();
+            if (shrunk.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+                throw std::runtime_error("Retired workers were never reaped!");
+            }
+            auto result = pool.enqueue([] { return 7; });
+            std::cout << "Retirement completed, pool still runs tasks: " << result.get() << std::endl;
+        }
+
+        std::cout << "\n--- Testing Grow Withdraws Outstanding Tokens ---" << std::endl;
+        {
+            pool.resize(4).get();
+            size_t peak = pool.getPeakThreadCount();
+            std::atomic<int> started{0};
+            std::promise<void> release = blockWorkers(pool, 4, started);
+
+            std::future<void> shrunk = pool.resize(2);
+            std::future<void> regrown = pool.resize(4);
+            bool bothReady = shrunk.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+                             regrown.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            std::cout << "Both resizes done without a retirement: " << (bothReady ? "Yes" : "No")
+                      << ", threads " << pool.getThreadCount() << ", peak " << pool.getPeakThreadCount() << std::endl;
+            release.set_value();
+            if (!bothReady || pool.getThreadCount() != 4 || pool.getPeakThreadCount() != peak) {
+                throw std::runtime_error("Regrowing did not reuse the workers about to retire!");
+            }
+            pool.waitForCompletion();
+        }
+
+        std::cout << "\n--- Testing Repeated Shrink And Grow ---" << std::endl;
+        {
+            std::atomic<int> executed{0};
+            for (int cycle = 0; cycle < 20; ++cycle) {
+                for (int i = 0; i < 20; ++i) {
+                    pool.post([&executed] { ++executed; });
+                }
+                pool.resize(cycle % 2 == 0 ? 1 : 4);
+            }
+            pool.resize(2).get();
+            pool.waitForCompletion();
+            std::cout << "Executed " << executed << " tasks, threads " << pool.getThreadCount()
+                      << ", peak " << pool.getPeakThreadCount() << std::endl;
+            // Reused IDs: never more live threads than ever requested at once
+            if (executed != 400 || pool.getThreadCount() != 2 || pool.getPeakThreadCount() > 8) {
+                throw std::runtime_error("Shrink/grow cycles lost tasks or threads!");
+            }
+        }
+
+        std::cout << "\n--- Testing Shrink To Zero And Back ---" << std::endl;
+        {
+            pool.resize(0).get();
+            auto result = pool.enqueue([] { return 3; });
+            bool ranWithoutWorkers = result.wait_for(std::chrono::milliseconds(20)) == std::future_status::ready;
+            pool.resize(2);
+            std::cout << "Queued task ran with zero workers: " << (ranWithoutWorkers ? "Yes" : "No")
+                      << ", result after regrowing: " << result.get() << std::endl;
+            if (ranWithoutWorkers) {
+                throw std::runtime_error("A task ran on a pool without workers!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 22 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+// Whether text contains the given line start
+bool hasLine(const std::string& text, const std::string& start) {
+    return text.find("\n" + start) != std::string::npos || text.compare(0, start.size(), start) == 0;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 23 Test (Metrics) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Histogram Buckets ---" << std::endl;
+        {
+            // Every value lies inside its bucket and buckets never exceed 1/16 of their values
+            for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull}) {
+                size_t bucket = LatencyHistogram::bucketOf(value);
+                uint64_t upper = LatencyHistogram::bucketUpperBound(bucket);
+                uint64_t lower = bucket == 0 ? 0 : LatencyHistogram::bucketUpperBound(bucket - 1) + 1;
+                std::cout << value << " -> bucket " << bucket << " [" << lower << ", " << upper << "]" << std::endl;
+                if (bucket >= LatencyHistogram::kBuckets || value < lower || value > upper) {
+                    throw std::runtime_error("Value outside of its bucket!");
+                }
+                if (upper - lower > upper / LatencyHistogram::kSubBuckets) {
+                    throw std::runtime_error("Bucket wider than its precision!");
+                }
+            }
+        }
+
+        std::cout << "\n--- Testing Percentiles ---" << std::endl;
+        {
+            LatencyHistogram histogram;
+            for (uint64_t i = 1; i <= 1000; ++i) {
+                histogram.record(i * 1000);
+            }
+            HistogramSnapshot snapshot;
+            histogram.addTo(snapshot);
+            uint64_t p50 = snapshot.percentile(0.5);
+            uint64_t p99 = snapshot.percentile(0.99);
+            std::cout << "count " << snapshot.count << ", mean " << snapshot.mean()
+                      << ", p50 " << p50 << ", p99 " << p99 << std::endl;
+            if (snapshot.count != 1000 || snapshot.sum != 500500000) {
+                throw std::runtime_error("Wrong histogram count or sum!");
+            }
+            if (p50 < 500000 || p50 > 500000 + 500000 / 16 || p99 < 990000 || p99 > 990000 + 990000 / 16) {
+                throw std::runtime_error("Percentile off by more than one bucket!");
+            }
+            if (HistogramSnapshot().percentile(0.5) != 0) {
+                throw std::runtime_error("Empty histogram reported a percentile!");
+            }
+        }
+
+        std::cout << "\n--- Testing Snapshot Counters ---" << std::endl;
+        {
+            ThreadPool pool(3);
+            const int count = 300;
+            std::vector<std::future<int>> results;
+            for (int i = 0; i < count; ++i) {
+                results.push_back(pool.enqueue([i] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    return i;
+                }));
+            }
+            pool.post([] { throw std::runtime_error("task failure"); });
+            for (auto& result : results) {
+                result.get();
+            }
+            pool.waitForCompletion();
+
+            MetricsSnapshot snapshot = pool.snapshot();
+            uint64_t perWorker = 0;
+            for (const WorkerMetrics& worker : snapshot.workers) {
+                std::cout << "worker " << worker.id << ": completed " << worker.completed
+                          << ", failed " << worker.failed << ", stolen " << worker.stolen
+                          << ", parked " << worker.parked << std::endl;
+                perWorker += worker.completed + worker.failed;
+            }
+            std::cout << "completed " << snapshot.completed << ", failed " << snapshot.failed << std::endl;
+            if (snapshot.workers.size() != 3) {
+                throw std::runtime_error("Wrong number of workers in the snapshot!");
+            }
+            if (snapshot.completed != pool.getCompletedTaskCount() || snapshot.failed != pool.getFailedTaskCount()) {
+                throw std::runtime_error("Snapshot disagrees with the pool getters!");
+            }
+            // Only workers ran tasks here
+            if (perWorker != count + 1 || snapshot.completed != count || snapshot.failed != 1) {
+                throw std::runtime_error("Per-worker counters do not add up!");
+            }
+            if (snapshot.threads != 3 || snapshot.pending_tasks != 0) {
+                throw std::runtime_error("Wrong gauges in the snapshot!");
+            }
+
+#if THREADPOOL_METRICS
+            std::cout << "queue wait: count " << snapshot.queue_wait.count
+                      << ", p50 " << snapshot.queue_wait.percentile(0.5) << " ns" << std::endl;
+            std::cout << "execution: count " << snapshot.execution.count
+                      << ", p50 " << snapshot.execution.percentile(0.5) << " ns" << std::endl;
+            if (snapshot.queue_wait.count != count + 1 || snapshot.execution.count != count + 1) {
+                throw std::runtime_error("Not every task was timed!");
+            }
+            // Each task sleeps 50us
+            if (snapshot.execution.percentile(0.5) < 50000) {
+                throw std::runtime_error("Execution time shorter than the task!");
+            }
+#else
+            std::cout << "Histograms compiled out" << std::endl;
+            if (snapshot.queue_wait.count != 0 || !snapshot.execution.buckets.empty()) {
+                throw std::runtime_error("Histograms recorded with metrics compiled out!");
+            }
+#endif
+        }
+
+        std::cout << "\n--- Testing Queue Wait Of A Paused Pool ---" << std::endl;
+#if THREADPOOL_METRICS
+        {
+            ThreadPool pool(1);
+            pool.pause();
+            pool.post([] {});
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            pool.resume();
+            pool.waitForCompletion();
+            uint64_t waited = pool.snapshot().queue_wait.percentile(1.0);
+            std::cout << "Queue wait: " << waited / 1000000.0 << " ms" << std::endl;
+            if (waited < 20000000) {
+                throw std::runtime_error("Queue wait does not include the paused time!");
+            }
+        }
+#else
+        std::cout << "Skipped, metrics compiled out" << std::endl;
+#endif
+
+        std::cout << "\n--- Testing Prometheus Export ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            pool.enqueue([] { return 1; }).get();
+            pool.waitForCompletion();
+            std::string text = toPrometheus(pool.snapshot(), "pool");
+            std::cout << text.substr(0, text.find("# TYPE pool_queue_wait")) << "..." << std::endl;
+            for (const char* line : {"# TYPE pool_threads gauge", "pool_threads 2",
+                                     "# TYPE pool_tasks_completed_total counter", "pool_tasks_completed_total 1",
+                                     "pool_worker_tasks_completed_total{worker=\"0\"}"}) {
+                if (!hasLine(text, line)) {
+                    throw std::runtime_error(std::string("Missing Prometheus line: ") + line);
+                }
+            }
+#if THREADPOOL_METRICS
+            for (const char* line : {"# TYPE pool_queue_wait_seconds histogram",
+                                     "pool_queue_wait_seconds_bucket{le=\"+Inf\"} 1",
+                                     "pool_execution_seconds_count 1"}) {
+                if (!hasLine(text, line)) {
+                    throw std::runtime_error(std::string("Missing Prometheus line: ") + line);
+                }
+            }
+#endif
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 23 Test Completed ===" << std::endl;
+    return 0;
+}
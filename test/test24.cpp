@@ -0,0 +1,170 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+// Pool with tracing enabled
+ThreadPoolOptions traceOptions(size_t capacity, uint32_t sampleEvery = 1) {
+    ThreadPoolOptions options;
+    options.trace.capacity = capacity;
+    options.trace.sample_every = sampleEvery;
+    return options;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 24 Test (Task Tracing) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Task Records ---" << std::endl;
+        {
+            ThreadPool pool(2, traceOptions(1024));
+            std::vector<std::future<int>> results;
+            for (int i = 0; i < 20; ++i) {
+                results.push_back(pool.enqueue(tagged("square", [](int x) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    return x * x;
+                }), i));
+            }
+            pool.post(tagged("boom", [] { throw std::runtime_error("traced failure"); }));
+            pool.post([] {});
+            for (int i = 0; i < 20; ++i) {
+                if (results[i].get() != i * i) {
+                    throw std::runtime_error("Tagged task returned the wrong result!");
+                }
+            }
+            pool.waitForCompletion();
+
+            std::vector<TaskInfo> tasks = pool.collectTrace();
+            std::set<uint64_t> ids;
+            size_t squares = 0, failures = 0, untagged = 0;
+            for (const TaskInfo& info : tasks) {
+                ids.insert(info.id);
+                std::string name = info.name ? info.name : "";
+                squares += name == "square";
+                untagged += name.empty();
+                if (name == "boom") {
+                    ++failures;
+                    if (info.outcome != TaskOutcome::Failed) {
+                        throw std::runtime_error("Throwing task not recorded as failed!");
+                    }
+                }
+                if (info.worker >= 2 || info.start_time == 0 || info.end_time < info.start_time) {
+                    throw std::runtime_error("Malformed task record!");
+                }
+#if THREADPOOL_METRICS
+                if (info.submit_time == 0 || info.submit_time > info.start_time) {
+                    throw std::runtime_error("Missing submission time!");
+                }
+#endif
+            }
+            std::cout << tasks.size() << " records: " << squares << " square, " << failures
+                      << " boom, " << untagged << " untagged" << std::endl;
+            if (tasks.size() != 22 || squares != 20 || failures != 1 || untagged != 1) {
+                throw std::runtime_error("Wrong task records!");
+            }
+            if (ids.size() != tasks.size()) {
+                throw std::runtime_error("Task IDs are not unique!");
+            }
+            for (size_t i = 1; i < tasks.size(); ++i) {
+                if (tasks[i].start_time < tasks[i - 1].start_time) {
+                    throw std::runtime_error("Records not ordered by start time!");
+                }
+            }
+            if (!pool.collectTrace().empty()) {
+                throw std::runtime_error("collectTrace() returned records twice!");
+            }
+        }
+
+        std::cout << "\n--- Testing Tasks Run Outside The Pool ---" << std::endl;
+        {
+            // The second task finds the bounded pool full and runs on this thread
+            ThreadPoolOptions options = traceOptions(64);
+            options.capacity = 1;
+            options.overflow = OverflowPolicy::CallerRuns;
+            ThreadPool bounded(1, options);
+            bounded.pause();
+            bounded.post([] {});
+            bounded.post(tagged("caller", [] {}));
+            bounded.resume();
+            bounded.waitForCompletion();
+            bool external = false;
+            for (const TaskInfo& info : bounded.collectTrace()) {
+                if (info.name && std::string(info.name) == "caller") {
+                    external = info.worker == TaskInfo::kExternalWorker;
+                }
+            }
+            std::cout << "CallerRuns task recorded as external: " << (external ? "Yes" : "No") << std::endl;
+            if (!external) {
+                throw std::runtime_error("Task run by its submitter not recorded as external!");
+            }
+        }
+
+        std::cout << "\n--- Testing Sampling And Full Buffers ---" << std::endl;
+        {
+            ThreadPool sampled(1, traceOptions(1024, 10));
+            for (int i = 0; i < 100; ++i) {
+                sampled.post([] {});
+            }
+            sampled.waitForCompletion();
+            size_t recorded = sampled.collectTrace().size();
+            std::cout << "Recorded " << recorded << " of 100 tasks sampling 1 in 10" << std::endl;
+            if (recorded != 10) {
+                throw std::runtime_error("Sampling recorded the wrong number of tasks!");
+            }
+
+            ThreadPool small(1, traceOptions(16));
+            for (int i = 0; i < 40; ++i) {
+                small.post([] {});
+            }
+            small.waitForCompletion();
+            size_t kept = small.collectTrace().size();
+            std::cout << "Kept " << kept << ", dropped " << small.getDroppedTraceCount() << std::endl;
+            if (kept != 16 || small.getDroppedTraceCount() != 24) {
+                throw std::runtime_error("Full trace buffer did not drop the newest records!");
+            }
+
+            ThreadPool untraced(1);
+            untraced.post([] {});
+            untraced.waitForCompletion();
+            if (!untraced.collectTrace().empty() || untraced.getDroppedTraceCount() != 0) {
+                throw std::runtime_error("Records without tracing enabled!");
+            }
+        }
+
+        std::cout << "\n--- Testing Chrome Trace Export ---" << std::endl;
+        {
+            TaskInfo worker;
+            worker.id = 7;
+            worker.name = "say \"hi\"";
+            worker.submit_time = 1000;
+            worker.start_time = 3000;
+            worker.end_time = 8500;
+            worker.worker = 0;
+            TaskInfo external;
+            external.start_time = 9000;
+            external.end_time = 9000;
+            external.outcome = TaskOutcome::Failed;
+
+            std::string json = toChromeTrace({worker, external});
+            std::cout << json;
+            for (const char* part : {"\"traceEvents\":[", "\"name\":\"thread_name\",\"args\":{\"name\":\"worker 0\"}",
+                                     "\"args\":{\"name\":\"external\"}", "\"name\":\"say \\\"hi\\\"\"",
+                                     "\"ts\":2.000,\"dur\":5.500", "\"queue_wait_us\":2.000",
+                                     "\"name\":\"task\"", "\"outcome\":\"failed\""}) {
+                if (json.find(part) == std::string::npos) {
+                    throw std::runtime_error(std::string("Missing in Chrome trace: ") + part);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 24 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+// Keeps every record it receives and the threads that delivered them
+class CollectingSink : public LogSink {
+public:
+    void write(const LogRecord& record) override {
+        if (gate) {
+            gate->wait();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        lines.push_back(formatLogRecord(record));
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    // Whether some record contains text
+    bool contains(const std::string& text) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& line : lines) {
+            if (line.find(text) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> lines;
+    std::vector<std::thread::id> threads;
+    // Blocks write() until released, when set
+    std::shared_future<void> const* gate = nullptr;
+};
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 25 Test (Logging) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Record Formatting ---" << std::endl;
+        {
+            LogRecord record;
+            record.level = LogLevel::Warning;
+            record.time = 3723000004000LL;   // 01:02:03.000004
+            record.message = "Resized {} -> {} workers, {} left";
+            record.values[0] = 4;
+            record.values[1] = 2;
+            record.detail = "detail";
+            std::string line = formatLogRecord(record);
+            std::cout << line << std::endl;
+            if (line != "01:02:03.000004 WARNING Resized 4 -> 2 workers, {} left: detail") {
+                throw std::runtime_error("Wrong formatted record!");
+            }
+        }
+
+        std::cout << "\n--- Testing Pool Messages And Levels ---" << std::endl;
+        {
+            std::ostringstream out;
+            ThreadPoolOptions options;
+            options.logger = std::make_shared<StreamLogSink>(out);
+            {
+                ThreadPool pool(2, options);
+                pool.pause();
+                pool.resume();
+                pool.waitForCompletion();
+            }
+            std::string text = out.str();
+            std::cout << text;
+            if (text.find("INFO Thread pool constructor called, creating 2 worker threads") == std::string::npos ||
+                text.find("INFO Thread pool has been paused") == std::string::npos ||
+                text.find("INFO Thread pool has been closed") == std::string::npos) {
+                throw std::runtime_error("Missing pool messages!");
+            }
+            if (text.find("DEBUG") != std::string::npos) {
+                throw std::runtime_error("Debug messages below the default level were logged!");
+            }
+
+            std::ostringstream quiet;
+            options.logger = std::make_shared<StreamLogSink>(quiet);
+            options.log_level = LogLevel::Error;
+            {
+                ThreadPool pool(1, options);
+                pool.post([] { throw std::runtime_error("logged failure"); });
+                pool.waitForCompletion();
+            }
+            std::cout << quiet.str();
+            if (quiet.str().find("ERROR Exception occurred in task on worker 0: logged failure") == std::string::npos ||
+                quiet.str().find("INFO") != std::string::npos) {
+                throw std::runtime_error("Level threshold not applied!");
+            }
+        }
+
+        std::cout << "\n--- Testing Async Sink ---" << std::endl;
+        {
+            auto target = std::make_shared<CollectingSink>();
+            {
+                AsyncLogSink sink(target);
+                LogRecord record;
+                record.message = "message {}";
+                for (int i = 0; i < 100; ++i) {
+                    record.values[0] = i;
+                    sink.write(record);
+                }
+                sink.flush();
+                std::cout << "Delivered " << target->lines.size() << " records" << std::endl;
+                if (target->lines.size() != 100 || !target->contains("message 99")) {
+                    throw std::runtime_error("Async sink lost records!");
+                }
+            }
+            for (auto id : target->threads) {
+                if (id == std::this_thread::get_id()) {
+                    throw std::runtime_error("Async sink wrote on the calling thread!");
+                }
+            }
+
+            // A stalled target fills the ring, writers drop instead of blocking
+            auto stalled = std::make_shared<CollectingSink>();
+            std::promise<void> release;
+            std::shared_future<void> gate = release.get_future().share();
+            stalled->gate = &gate;
+            {
+                AsyncLogSink sink(stalled, 8);
+                LogRecord record;
+                for (int i = 0; i < 100; ++i) {
+                    sink.write(record);
+                }
+                std::cout << "Dropped " << sink.getDroppedCount() << " records while stalled" << std::endl;
+                if (sink.getDroppedCount() == 0) {
+                    throw std::runtime_error("Full async sink did not drop!");
+                }
+                release.set_value();
+                sink.flush();
+                if (stalled->lines.size() + sink.getDroppedCount() != 100) {
+                    throw std::runtime_error("Records neither delivered nor dropped!");
+                }
+            }
+        }
+
+        std::cout << "\n--- Testing Structured Error Callback ---" << std::endl;
+        {
+            ThreadPool pool(1);
+            std::mutex mutex;
+            std::string message;
+            TaskInfo failed;
+            pool.setErrorHandler([&](std::exception_ptr error, const TaskInfo& info) {
+                std::lock_guard<std::mutex> lock(mutex);
+                try {
+                    std::rethrow_exception(error);
+                } catch (const std::exception& e) {
+                    message = e.what();
+                }
+                failed = info;
+            });
+            pool.post(tagged("loader", [] { throw std::runtime_error("disk full"); }));
+            pool.waitForCompletion();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::cout << "Handler got '" << message << "' from task "
+                      << (failed.name ? failed.name : "?") << " on worker " << failed.worker << std::endl;
+            if (message != "disk full" || !failed.name || std::string(failed.name) != "loader" ||
+                failed.worker != 0 || failed.outcome != TaskOutcome::Failed) {
+                throw std::runtime_error("Wrong error callback arguments!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 25 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+using namespace std::chrono;
+
+// Reason stored in a skipped task's future, throws if the task was not skipped
+template<class T>
+TaskCancelled::Reason skippedReason(std::future<T>& result) {
+    try {
+        result.get();
+    } catch (const TaskCancelled& e) {
+        return e.reason();
+    }
+    throw std::runtime_error("Task ran although it should have been skipped!");
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 26 Test (Cancellation And Deadlines) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Cancellation Tokens ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            std::atomic<int> ran{0};
+            CancellationSource request;
+            CancellationSource other;
+
+            pool.pause();
+            auto cancelled = pool.enqueue(request.token(), [&ran](int x) { ++ran; return x; }, 1);
+            auto kept = pool.enqueue(other.token(), [&ran](int x) { ++ran; return x; }, 2);
+            pool.post(request.token(), [&ran] { ++ran; });
+            request.cancel();
+            pool.resume();
+
+            bool reasonOk = skippedReason(cancelled) == TaskCancelled::Reason::Cancelled;
+            int keptValue = kept.get();
+            pool.waitForCompletion();
+            std::cout << "Cancelled future: " << (reasonOk ? "TaskCancelled(Cancelled)" : "wrong reason")
+                      << ", other request: " << keptValue << ", callables run: " << ran << std::endl;
+            std::cout << "Skipped: " << pool.getSkippedTaskCount()
+                      << ", completed: " << pool.getCompletedTaskCount() << std::endl;
+            if (!reasonOk || keptValue != 2 || ran != 1) {
+                throw std::runtime_error("Cancelled tasks were not skipped!");
+            }
+            if (pool.getSkippedTaskCount() != 2 || pool.getCompletedTaskCount() != 1 ||
+                pool.getFailedTaskCount() != 0) {
+                throw std::runtime_error("Skipped tasks counted wrongly!");
+            }
+            if (CancellationToken().isCancelled() || CancellationToken()) {
+                throw std::runtime_error("Default token reports cancellation!");
+            }
+        }
+
+        std::cout << "\n--- Testing Cooperative Cancellation ---" << std::endl;
+        {
+            ThreadPool pool(1);
+            CancellationSource source;
+            CancellationToken token = source.token();
+            std::atomic<bool> started{false};
+            auto result = pool.enqueue(token, [token, &started] {
+                started = true;
+                int polls = 0;
+                while (!token.isCancelled()) {
+                    ++polls;
+                    std::this_thread::sleep_for(milliseconds(1));
+                }
+                return polls;
+            });
+            while (!started) {
+                std::this_thread::yield();
+            }
+            source.cancel();
+            std::cout << "Running task stopped after " << result.get() << " polls" << std::endl;
+            pool.waitForCompletion();
+            if (pool.getSkippedTaskCount() != 0) {
+                throw std::runtime_error("A task that started was counted as skipped!");
+            }
+        }
+
+        std::cout << "\n--- Testing Deadlines ---" << std::endl;
+        {
+            ThreadPool pool(1);
+            pool.pause();
+            auto expired = pool.enqueueWithDeadline(steady_clock::now() + milliseconds(10), [] { return 1; });
+            auto inTime = pool.enqueueWithDeadline(steady_clock::now() + seconds(60), [] { return 2; });
+            std::this_thread::sleep_for(milliseconds(30));
+            pool.resume();
+
+            bool reasonOk = skippedReason(expired) == TaskCancelled::Reason::DeadlineExpired;
+            int value = inTime.get();
+            std::cout << "Expired future: " << (reasonOk ? "TaskCancelled(DeadlineExpired)" : "wrong reason")
+                      << ", in time: " << value << std::endl;
+            if (!reasonOk || value != 2) {
+                throw std::runtime_error("Deadlines not applied!");
+            }
+
+            // A cancelled token wins even before the deadline
+            CancellationSource source;
+            source.cancel();
+            auto both = pool.enqueueWithDeadline(steady_clock::now() + seconds(60), source.token(), [] {});
+            if (skippedReason(both) != TaskCancelled::Reason::Cancelled) {
+                throw std::runtime_error("Cancelled token ignored by enqueueWithDeadline!");
+            }
+        }
+
+        std::cout << "\n--- Testing Overload Sheds Expired Work ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.trace.capacity = 256;
+            ThreadPool pool(1, options);
+            std::atomic<int> ran{0};
+            pool.post([] { std::this_thread::sleep_for(milliseconds(50)); });
+            std::vector<std::future<void>> requests;
+            for (int i = 0; i < 100; ++i) {
+                requests.push_back(pool.enqueueWithDeadline(steady_clock::now() + milliseconds(5),
+                                                            tagged("request", [&ran] {
+                    ++ran;
+                    std::this_thread::sleep_for(milliseconds(1));
+                })));
+            }
+            auto begin = steady_clock::now();
+            pool.waitForCompletion();
+            auto drained = duration_cast<milliseconds>(steady_clock::now() - begin).count();
+
+            size_t skippedRecords = 0;
+            for (const TaskInfo& info : pool.collectTrace()) {
+                skippedRecords += info.outcome == TaskOutcome::Skipped;
+            }
+            MetricsSnapshot snapshot = pool.snapshot();
+            std::cout << "Ran " << ran << " of 100 expired requests, drained in " << drained << " ms, "
+                      << snapshot.skipped << " skipped, " << skippedRecords << " traced as skipped" << std::endl;
+            if (ran != 0 || snapshot.skipped != 100 || skippedRecords != 100) {
+                throw std::runtime_error("Expired requests were run under overload!");
+            }
+            if (toPrometheus(snapshot).find("threadpool_tasks_skipped_total 100") == std::string::npos) {
+                throw std::runtime_error("Skipped tasks missing from the Prometheus export!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 26 Test Completed ===" << std::endl;
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <string>
+#include <stdexcept>
+#include "ThreadPool.h"
+#include "Strand.h"
+
+using namespace std::chrono;
+
+// Flags any two tasks of the same serial executor that overlap
+struct OverlapDetector {
+    std::atomic<int> inside{0};
+    std::atomic<bool> overlapped{false};
+
+    void enter() {
+        if (inside.fetch_add(1) != 0) {
+            overlapped = true;
+        }
+    }
+    void leave() { inside.fetch_sub(1); }
+};
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 27 Test (Strands) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Strand Ordering With Concurrent Producers ---" << std::endl;
+        {
+            ThreadPool pool(4);
+            Strand strand(pool);
+            OverlapDetector detector;
+            const int producers = 4;
+            const int perProducer = 2000;
+            // Only touched by strand tasks, so no synchronization of its own
+            std::vector<int> lastSeen(producers, -1);
+            bool outOfOrder = false;
+
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&, p] {
+                    for (int i = 0; i < perProducer; ++i) {
+                        strand.post([&, p, i] {
+                            detector.enter();
+                            if (lastSeen[p] != i - 1) {
+                                outOfOrder = true;
+                            }
+                            lastSeen[p] = i;
+                            detector.leave();
+                        });
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            pool.waitForCompletion();
+
+            std::cout << "Ran " << producers * perProducer << " tasks, in order: " << (outOfOrder ? "no" : "yes")
+                      << ", overlapping: " << (detector.overlapped ? "yes" : "no")
+                      << ", still queued: " << strand.getTaskCount() << std::endl;
+            if (outOfOrder || detector.overlapped || strand.getTaskCount() != 0) {
+                throw std::runtime_error("Strand did not run tasks serially in order!");
+            }
+            for (int p = 0; p < producers; ++p) {
+                if (lastSeen[p] != perProducer - 1) {
+                    throw std::runtime_error("Strand lost tasks!");
+                }
+            }
+        }
+
+        std::cout << "\n--- Testing Strand Futures ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            Strand strand(pool);
+            Strand other(pool);
+            auto sum = strand.enqueue([](int a, int b) { return a + b; }, 2, 3);
+            auto inside = strand.enqueue([&] {
+                return strand.runningInThisThread() && !other.runningInThisThread();
+            });
+            auto failing = strand.enqueue([]() -> int { throw std::runtime_error("strand failure"); });
+
+            bool threw = false;
+            try {
+                failing.get();
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            std::cout << "Sum: " << sum.get() << ", running in strand: " << inside.get()
+                      << ", outside: " << strand.runningInThisThread()
+                      << ", exception in future: " << threw << std::endl;
+            if (!threw || strand.runningInThisThread()) {
+                throw std::runtime_error("Strand futures broken!");
+            }
+        }
+
+        std::cout << "\n--- Testing Batches Stay On One Worker ---" << std::endl;
+        {
+            ThreadPool pool(4);
+            const size_t batch = 16;
+            const int tasks = 160;
+            Strand strand(pool, batch);
+            std::vector<std::thread::id> ranOn;
+            ranOn.reserve(tasks);
+
+            pool.pause();
+            for (int i = 0; i < tasks; ++i) {
+                strand.post([&ranOn] { ranOn.push_back(std::this_thread::get_id()); });
+            }
+            pool.resume();
+            pool.waitForCompletion();
+
+            size_t switches = 0;
+            for (size_t i = 1; i < ranOn.size(); ++i) {
+                switches += ranOn[i] != ranOn[i - 1];
+            }
+            std::cout << tasks << " tasks in batches of " << batch << ": " << switches
+                      << " worker switches, pool tasks: " << pool.getCompletedTaskCount() << std::endl;
+            if (ranOn.size() != static_cast<size_t>(tasks) || switches > tasks / batch - 1) {
+                throw std::runtime_error("Strand batch moved between workers!");
+            }
+            // One pool task per batch
+            if (pool.getCompletedTaskCount() != tasks / batch) {
+                throw std::runtime_error("Strand batches not run back-to-back!");
+            }
+        }
+
+        std::cout << "\n--- Testing Keyed Executor ---" << std::endl;
+        {
+            ThreadPool pool(4);
+            KeyedExecutor<std::string> keyed(pool, 16);
+            const int keys = 8;
+            const int perKey = 500;
+            std::vector<OverlapDetector> detectors(keys);
+            std::vector<int> lastSeen(keys, -1);
+            std::atomic<bool> outOfOrder{false};
+
+            // Producers interleave the keys, each key is submitted by one producer
+            std::vector<std::thread> threads;
+            for (int p = 0; p < 2; ++p) {
+                threads.emplace_back([&, p] {
+                    for (int i = 0; i < perKey; ++i) {
+                        for (int k = p; k < keys; k += 2) {
+                            keyed.post("account-" + std::to_string(k), [&, k, i] {
+                                detectors[k].enter();
+                                if (lastSeen[k] != i - 1) {
+                                    outOfOrder = true;
+                                }
+                                lastSeen[k] = i;
+                                detectors[k].leave();
+                            });
+                        }
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            auto last = keyed.enqueue("account-0", [&lastSeen] { return lastSeen[0]; });
+            int lastOfKey0 = last.get();
+            pool.waitForCompletion();
+
+            bool overlapped = false;
+            for (auto& detector : detectors) {
+                overlapped = overlapped || detector.overlapped;
+            }
+            std::cout << keys << " keys x " << perKey << " tasks, in order: " << (outOfOrder ? "no" : "yes")
+                      << ", overlapping per key: " << (overlapped ? "yes" : "no")
+                      << ", last of account-0 seen by a later task: " << lastOfKey0 << std::endl;
+            if (outOfOrder || overlapped || lastOfKey0 != perKey - 1) {
+                throw std::runtime_error("Keyed executor broke per-key ordering!");
+            }
+            if (&keyed.strandFor("account-3") != &keyed.strandFor("account-3")) {
+                throw std::runtime_error("Key mapped to different strands!");
+            }
+        }
+
+        std::cout << "\n--- Testing Strand Error Reporting ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            Strand strand(pool);
+            std::atomic<int> reported{0};
+            std::atomic<int> ranAfter{0};
+            std::string reportedName;
+            pool.setErrorHandler([&](std::exception_ptr, const TaskInfo& info) {
+                reportedName = info.name ? info.name : "";
+                ++reported;
+            });
+
+            pool.pause();
+            strand.post(tagged("ledger-update", [] { throw std::runtime_error("bad entry"); }));
+            strand.post([&ranAfter] { ++ranAfter; });
+            pool.resume();
+            pool.waitForCompletion();
+
+            std::cout << "Reported: " << reported << " (" << reportedName << "), ran after failure: "
+                      << ranAfter << ", failed pool tasks: " << pool.getFailedTaskCount() << std::endl;
+            if (reported != 1 || reportedName != "ledger-update" || ranAfter != 1 ||
+                pool.getFailedTaskCount() != 1) {
+                throw std::runtime_error("Strand task failure not reported!");
+            }
+        }
+
+        std::cout << "\n--- Testing Strands On A Bounded Pool ---" << std::endl;
+        {
+            ThreadPoolOptions options;
+            options.capacity = 1;
+            options.overflow = OverflowPolicy::Reject;
+            ThreadPool pool(1, options);
+            Strand first(pool);
+            Strand second(pool);
+            std::atomic<int> ran{0};
+
+            // A full pool still takes the drains of strands that hold accepted work
+            pool.pause();
+            for (int i = 0; i < 100; ++i) {
+                first.post([&ran] { ++ran; });
+                second.post([&ran] { ++ran; });
+            }
+            pool.resume();
+            pool.waitForCompletion();
+            std::cout << "Ran " << ran << " of 200 strand tasks, rejected: " << pool.getRejectedTaskCount() << std::endl;
+            if (ran != 200 || pool.getRejectedTaskCount() != 0) {
+                throw std::runtime_error("Strand drain was refused by a bounded pool!");
+            }
+        }
+
+        std::cout << "\n--- Testing Strand Survives clearTasks ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            Strand strand(pool);
+            std::atomic<int> ran{0};
+
+            pool.pause();
+            for (int i = 0; i < 10; ++i) {
+                strand.post([&ran] { ++ran; });
+            }
+            auto dropped = strand.enqueue([] { return 1; });
+            pool.clearTasks();
+            pool.resume();
+
+            bool broken = false;
+            try {
+                dropped.get();
+            } catch (const std::future_error& e) {
+                broken = e.code() == std::future_errc::broken_promise;
+            }
+            auto after = strand.enqueue([&ran] { return ran.load(); });
+            int ranBefore = after.get();
+            std::cout << "Cleared strand tasks run: " << ranBefore << ", dropped future broken: " << broken
+                      << ", queued: " << strand.getTaskCount() << std::endl;
+            if (ranBefore != 0 || !broken) {
+                throw std::runtime_error("Cleared strand tasks were run!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 27 Test Completed ===" << std::endl;
+    return 0;
+}
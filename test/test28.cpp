@@ -0,0 +1,220 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include "ThreadPool.h"
+
+// Too large for TaskFunction's inline buffer, small enough for a slab class
+struct MediumPayload {
+    std::array<char, 200> bytes{};
+};
+
+// Larger than the biggest slab class
+struct LargePayload {
+    std::array<char, 2048> bytes{};
+};
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 28 Test (Slab Heaps) ===" << std::endl;
+
+    try {
+        SlabPool& slab = SlabPool::instance();
+
+        std::cout << "\n--- Testing Cross-Thread Task Allocations ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            const int tasks = 20000;
+            std::atomic<int> ran{0};
+            // Warm up the heaps so the measured rounds can recycle blocks
+            for (int round = 0; round < 2; ++round) {
+                std::vector<std::future<int>> results;
+                results.reserve(tasks);
+                SlabStats before = slab.stats();
+                for (int i = 0; i < tasks; ++i) {
+                    MediumPayload payload;
+                    payload.bytes[0] = static_cast<char>(i);
+                    results.push_back(pool.enqueue([payload, &ran] { ++ran; return static_cast<int>(payload.bytes[0]); }));
+                }
+                for (auto& result : results) {
+                    result.get();
+                }
+                pool.waitForCompletion();
+                results.clear();
+                SlabStats after = slab.stats();
+
+                uint64_t hits = after.hits - before.hits;
+                uint64_t misses = after.misses - before.misses;
+                uint64_t remote = after.remote_frees - before.remote_frees;
+                std::cout << "Round " << round << ": " << hits << " hits, " << misses << " misses, "
+                          << remote << " remote frees, " << after.chunks << " chunks, peak "
+                          << after.peak_bytes_reserved / 1024 << " KiB" << std::endl;
+                // Closure and shared state per task, both from the slab
+                if (hits + misses < 2u * tasks) {
+                    throw std::runtime_error("Task closures or shared states bypassed the slab pool!");
+                }
+                if (remote == 0) {
+                    throw std::runtime_error("Closures freed on workers were not counted as remote frees!");
+                }
+                if (round == 1 && misses * 100 > hits) {
+                    throw std::runtime_error("Steady state keeps reaching the global heap!");
+                }
+            }
+            if (ran != 2 * tasks) {
+                throw std::runtime_error("Tasks lost!");
+            }
+        }
+
+        std::cout << "\n--- Testing Oversize Fallback ---" << std::endl;
+        {
+            SlabStats before = slab.stats();
+            std::atomic<int> ran{0};
+            {
+                ThreadPool pool(1);
+                for (int i = 0; i < 10; ++i) {
+                    LargePayload payload;
+                    pool.post([payload, &ran] { ran += payload.bytes[0] + 1; });
+                }
+                pool.waitForCompletion();
+                // Joining the worker makes sure the last closure was destroyed too
+            }
+            SlabStats after = slab.stats();
+            std::cout << "Oversize closures: " << ran << ", misses: " << after.misses - before.misses
+                      << ", bytes in use before/after: " << before.bytes_in_use << "/" << after.bytes_in_use << std::endl;
+            if (ran != 10 || after.misses - before.misses < 10) {
+                throw std::runtime_error("Oversize closures not served by the global heap!");
+            }
+            if (after.bytes_in_use != before.bytes_in_use) {
+                throw std::runtime_error("Oversize closures leaked!");
+            }
+        }
+
+        std::cout << "\n--- Testing Heaps Outlive Their Threads ---" << std::endl;
+        {
+            const int blocks = 500;
+            std::vector<void*> handedOver;
+            std::thread producer([&] {
+                for (int i = 0; i < blocks; ++i) {
+                    handedOver.push_back(slab.allocate(256));
+                }
+            });
+            producer.join();
+            // Freed after the owning thread exited: goes to the orphaned heap
+            SlabStats before = slab.stats();
+            for (void* p : handedOver) {
+                slab.deallocate(p, 256);
+            }
+            SlabStats freed = slab.stats();
+
+            // Threads started one after another adopt that heap and reuse its blocks
+            for (int t = 0; t < 4; ++t) {
+                std::thread reuse([&] {
+                    std::vector<void*> mine;
+                    for (int i = 0; i < blocks; ++i) {
+                        mine.push_back(slab.allocate(256));
+                    }
+                    for (void* p : mine) {
+                        slab.deallocate(p, 256);
+                    }
+                });
+                reuse.join();
+            }
+            SlabStats after = slab.stats();
+            std::cout << "Remote frees to the exited heap: " << freed.remote_frees - before.remote_frees
+                      << ", chunks before/after four more threads: " << freed.chunks << "/" << after.chunks
+                      << ", misses: " << after.misses - freed.misses << std::endl;
+            if (freed.remote_frees - before.remote_frees != static_cast<uint64_t>(blocks)) {
+                throw std::runtime_error("Frees after the owner exited not counted as remote!");
+            }
+            if (after.chunks != freed.chunks || after.misses != freed.misses) {
+                throw std::runtime_error("Heap of an exited thread was not reused!");
+            }
+        }
+
+        std::cout << "\n--- Testing Concurrent Remote Frees ---" << std::endl;
+        {
+            const int perThread = 20000;
+            std::mutex handoffMutex;
+            std::vector<void*> handoff;
+            std::atomic<bool> done{false};
+            std::atomic<int> freedCount{0};
+
+            std::thread consumer([&] {
+                std::vector<void*> batch;
+                for (;;) {
+                    bool finished = false;
+                    {
+                        std::lock_guard<std::mutex> lock(handoffMutex);
+                        batch.swap(handoff);
+                        finished = done;
+                    }
+                    for (void* p : batch) {
+                        // Written by the producer, read back before the block is recycled
+                        if (*static_cast<int*>(p) != 42) {
+                            throw std::runtime_error("Block corrupted!");
+                        }
+                        slab.deallocate(p, 64);
+                        ++freedCount;
+                    }
+                    batch.clear();
+                    // done is set under the lock after the last push, so that swap took everything
+                    if (finished) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+            std::vector<std::thread> producers;
+            for (int t = 0; t < 2; ++t) {
+                producers.emplace_back([&] {
+                    for (int i = 0; i < perThread; ++i) {
+                        void* p = slab.allocate(64);
+                        *static_cast<int*>(p) = 42;
+                        std::lock_guard<std::mutex> lock(handoffMutex);
+                        handoff.push_back(p);
+                    }
+                });
+            }
+            for (auto& t : producers) {
+                t.join();
+            }
+            {
+                std::lock_guard<std::mutex> lock(handoffMutex);
+                done = true;
+            }
+            consumer.join();
+            std::cout << "Blocks allocated on 2 producers and freed on a consumer: " << freedCount << std::endl;
+            if (freedCount != 2 * perThread) {
+                throw std::runtime_error("Remote frees lost blocks!");
+            }
+        }
+
+        std::cout << "\n--- Testing Allocator Stats Export ---" << std::endl;
+        {
+            ThreadPool pool(1);
+            pool.enqueue([] { return 1; }).get();
+            MetricsSnapshot snapshot = pool.snapshot();
+            std::string text = toPrometheus(snapshot);
+            std::cout << "Snapshot: " << snapshot.allocator.hits << " hits, " << snapshot.allocator.misses
+                      << " misses, " << snapshot.allocator.bytes_in_use << " bytes in use, "
+                      << snapshot.allocator.bytes_reserved << " reserved" << std::endl;
+            if (snapshot.allocator.hits == 0 || snapshot.allocator.bytes_reserved == 0 ||
+                snapshot.allocator.peak_bytes_reserved < snapshot.allocator.bytes_reserved) {
+                throw std::runtime_error("Allocator stats missing from the snapshot!");
+            }
+            if (text.find("threadpool_allocator_hits_total") == std::string::npos ||
+                text.find("threadpool_allocator_peak_bytes_reserved") == std::string::npos) {
+                throw std::runtime_error("Allocator stats missing from the Prometheus export!");
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 28 Test Completed ===" << std::endl;
+    return 0;
+}
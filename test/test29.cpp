@@ -0,0 +1,295 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include "ThreadPool.h"
+#include "PartitionedExecutor.h"
+#if defined(__linux__)
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+
+// Highest number of tasks inside a section at once
+struct ConcurrencyTracker {
+    std::atomic<int> inside{0};
+    std::atomic<int> peak{0};
+
+    void enter() {
+        int now = ++inside;
+        int seen = peak;
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+        }
+    }
+    void leave() { --inside; }
+};
+
+PartitionOptions partitionOptions(const std::string& name, unsigned weight = 1) {
+    PartitionOptions options;
+    options.name = name;
+    options.weight = weight;
+    return options;
+}
+
+#if defined(__linux__)
+int currentNice() {
+    return getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+}
+#endif
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 29 Test (Partitioned Executor) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Testing Weighted Fair Scheduling ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            // One worker for the executor, so the dispatch order is the schedule
+            PartitionedExecutor executor(pool, 1);
+            Partition& interactive = executor.addPartition(partitionOptions("interactive", 3));
+            Partition& batch = executor.addPartition(partitionOptions("batch", 1));
+            std::vector<char> order;
+
+            pool.pause();
+            for (int i = 0; i < 400; ++i) {
+                interactive.post([&order] { order.push_back('i'); });
+                batch.post([&order] { order.push_back('b'); });
+            }
+            pool.resume();
+            executor.wait();
+
+            int interactiveFirst = 0;
+            for (size_t i = 0; i < 200; ++i) {
+                interactiveFirst += order[i] == 'i';
+            }
+            std::cout << "Of the first 200 dispatches " << interactiveFirst << " went to the weight-3 partition, "
+                      << order.size() << " tasks ran in total" << std::endl;
+            if (order.size() != 800 || interactive.getCompletedTaskCount() != 400 ||
+                batch.getCompletedTaskCount() != 400) {
+                throw std::runtime_error("Partition tasks lost!");
+            }
+            if (interactiveFirst < 148 || interactiveFirst > 152) {
+                throw std::runtime_error("Weights not honoured!");
+            }
+        }
+
+        std::cout << "\n--- Testing Max Workers Per Partition ---" << std::endl;
+        {
+            ThreadPool pool(4);
+            PartitionedExecutor executor(pool);
+            PartitionOptions ioOptions = partitionOptions("io");
+            ioOptions.max_workers = 1;
+            Partition& io = executor.addPartition(ioOptions);
+            Partition& cpu = executor.addPartition(partitionOptions("cpu"));
+            ConcurrencyTracker ioTracker;
+            ConcurrencyTracker cpuTracker;
+            ConcurrencyTracker allTracker;
+
+            for (int i = 0; i < 8; ++i) {
+                io.post([&] {
+                    ioTracker.enter();
+                    allTracker.enter();
+                    std::this_thread::sleep_for(milliseconds(5));
+                    allTracker.leave();
+                    ioTracker.leave();
+                });
+                cpu.post([&] {
+                    cpuTracker.enter();
+                    allTracker.enter();
+                    std::this_thread::sleep_for(milliseconds(5));
+                    allTracker.leave();
+                    cpuTracker.leave();
+                });
+            }
+            executor.wait();
+            std::cout << "Peak running: io " << ioTracker.peak << ", cpu " << cpuTracker.peak
+                      << ", all " << allTracker.peak << " of " << executor.getMaxWorkers() << std::endl;
+            if (ioTracker.peak != 1 || cpuTracker.peak < 2 ||
+                allTracker.peak > static_cast<int>(executor.getMaxWorkers())) {
+                throw std::runtime_error("max_workers not enforced!");
+            }
+        }
+
+        std::cout << "\n--- Testing Reserved Workers ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            PartitionedExecutor executor(pool);
+            Partition& bulk = executor.addPartition(partitionOptions("bulk"));
+            PartitionOptions latencyOptions = partitionOptions("latency");
+            latencyOptions.min_workers = 1;
+            Partition& latency = executor.addPartition(latencyOptions);
+            ConcurrencyTracker bulkTracker;
+
+            for (int i = 0; i < 10; ++i) {
+                bulk.post([&bulkTracker] {
+                    bulkTracker.enter();
+                    std::this_thread::sleep_for(milliseconds(20));
+                    bulkTracker.leave();
+                });
+            }
+            std::this_thread::sleep_for(milliseconds(5));
+            auto submitted = steady_clock::now();
+            auto started = latency.enqueue([] { return steady_clock::now(); });
+            auto delay = duration_cast<milliseconds>(started.get() - submitted).count();
+            executor.wait();
+
+            std::cout << "Latency task started after " << delay << " ms behind a bulk backlog, bulk peak "
+                      << bulkTracker.peak << " of " << executor.getMaxWorkers() << " workers" << std::endl;
+            if (bulkTracker.peak != 1) {
+                throw std::runtime_error("Bulk partition used the reserved worker!");
+            }
+            if (delay >= 15) {
+                throw std::runtime_error("Reserved worker was not free for the latency partition!");
+            }
+        }
+
+        std::cout << "\n--- Testing Shared Thread Budget ---" << std::endl;
+        {
+            ThreadPool pool(8);
+            PartitionedExecutor executor(pool, 3);
+            ConcurrencyTracker tracker;
+            for (const char* name : {"a", "b", "c"}) {
+                Partition& partition = executor.addPartition(partitionOptions(name));
+                for (int i = 0; i < 6; ++i) {
+                    partition.post([&tracker] {
+                        tracker.enter();
+                        std::this_thread::sleep_for(milliseconds(5));
+                        tracker.leave();
+                    });
+                }
+            }
+            executor.wait();
+            std::cout << "Peak running over three partitions: " << tracker.peak << " of 3 allowed" << std::endl;
+            if (tracker.peak != 3) {
+                throw std::runtime_error("Executor thread budget not respected!");
+            }
+        }
+
+        std::cout << "\n--- Testing Futures, Errors And Configuration ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            std::atomic<int> reported{0};
+            pool.setErrorHandler([&reported](std::exception_ptr, const TaskInfo&) { ++reported; });
+            PartitionedExecutor executor(pool);
+            executor.addPartition(partitionOptions("jobs"));
+            Partition* jobs = executor.getPartition("jobs");
+            if (!jobs || executor.getPartition("missing")) {
+                throw std::runtime_error("Partition lookup by name broken!");
+            }
+
+            auto product = jobs->enqueue([](int a, int b) { return a * b; }, 6, 7);
+            auto failing = jobs->enqueue([]() -> int { throw std::runtime_error("job failed"); });
+            jobs->post([] { throw std::runtime_error("posted job failed"); });
+            bool threw = false;
+            try {
+                failing.get();
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            int value = product.get();
+            executor.wait();
+            std::cout << "Product: " << value << ", future exception: " << threw << ", reported: " << reported
+                      << ", completed/failed: " << jobs->getCompletedTaskCount() << "/" << jobs->getFailedTaskCount()
+                      << std::endl;
+            if (value != 42 || !threw || reported != 1 || jobs->getFailedTaskCount() != 1 ||
+                jobs->getCompletedTaskCount() != 2) {
+                throw std::runtime_error("Partition results or errors wrong!");
+            }
+
+            int rejected = 0;
+            PartitionOptions zeroWeight = partitionOptions("zero", 0);
+            PartitionOptions tooMany = partitionOptions("greedy");
+            tooMany.min_workers = executor.getMaxWorkers() + 1;
+            PartitionOptions inverted = partitionOptions("inverted");
+            inverted.min_workers = 2;
+            inverted.max_workers = 1;
+            for (const PartitionOptions& options : {zeroWeight, tooMany, inverted, partitionOptions("jobs")}) {
+                try {
+                    executor.addPartition(options);
+                } catch (const std::invalid_argument&) {
+                    ++rejected;
+                }
+            }
+            std::cout << "Invalid partitions rejected: " << rejected << " of 4" << std::endl;
+            if (rejected != 4) {
+                throw std::runtime_error("Invalid partition options accepted!");
+            }
+        }
+
+        std::cout << "\n--- Testing Runners Survive clearTasks ---" << std::endl;
+        {
+            ThreadPool pool(2);
+            PartitionedExecutor executor(pool);
+            Partition& jobs = executor.addPartition(partitionOptions("jobs"));
+            std::atomic<int> ran{0};
+
+            pool.pause();
+            for (int i = 0; i < 20; ++i) {
+                jobs.post([&ran] { ++ran; });
+            }
+            // Removes the runner tasks, not the partition's own queue
+            pool.clearTasks();
+            pool.resume();
+            executor.wait();
+            std::cout << "Partition tasks run after the pool queue was cleared: " << ran << std::endl;
+            if (ran != 20) {
+                throw std::runtime_error("Partition stalled after its runners were cleared!");
+            }
+        }
+
+#if defined(__linux__)
+        std::cout << "\n--- Testing Partition Scheduling Settings ---" << std::endl;
+        {
+            ThreadPool pool(1);
+            PartitionedExecutor executor(pool);
+            PartitionOptions backgroundOptions = partitionOptions("background");
+            backgroundOptions.nice = 5;
+            backgroundOptions.batch_scheduling = true;
+            Partition& background = executor.addPartition(backgroundOptions);
+            Partition& foreground = executor.addPartition(partitionOptions("foreground"));
+
+            int baseNice = pool.enqueue(currentNice).get();
+            auto inBackground = background.enqueue([] {
+                return std::make_pair(currentNice(), sched_getscheduler(0));
+            });
+            auto settings = inBackground.get();
+            auto inForeground = foreground.enqueue([] {
+                return std::make_pair(currentNice(), sched_getscheduler(0));
+            });
+            auto restored = inForeground.get();
+            executor.wait();
+            int afterwards = pool.enqueue(currentNice).get();
+
+            std::cout << "Nice applied: " << background.isNiceApplied() << ", background nice/policy: "
+                      << settings.first << "/" << (settings.second == SCHED_BATCH ? "SCHED_BATCH" : "other")
+                      << ", foreground: " << restored.first << "/"
+                      << (restored.second == SCHED_BATCH ? "SCHED_BATCH" : "other")
+                      << ", plain pool task: " << afterwards << std::endl;
+            if (settings.second != SCHED_BATCH || restored.second == SCHED_BATCH) {
+                throw std::runtime_error("SCHED_BATCH not switched per partition!");
+            }
+            if (background.isNiceApplied() && (settings.first != 5 || restored.first != baseNice)) {
+                throw std::runtime_error("Nice value not switched per partition!");
+            }
+            if (afterwards != baseNice) {
+                throw std::runtime_error("Worker kept the partition's nice value!");
+            }
+        }
+#endif
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 29 Test Completed ===" << std::endl;
+    return 0;
+}
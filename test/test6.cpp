@@ -0,0 +1,83 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "ThreadPool.h"
+
+// Test function: Recursively fan out tasks from inside worker threads
+void spawnTree(ThreadPool& pool, int depth, std::atomic<int>& leaves) {
+    if (depth == 0) {
+        ++leaves;
+        return;
+    }
+    // Nested submissions go to the worker's local deque and get stolen by idle workers
+    pool.enqueue(spawnTree, std::ref(pool), depth - 1, std::ref(leaves));
+    pool.enqueue(spawnTree, std::ref(pool), depth - 1, std::ref(leaves));
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 6 Test (Work Stealing) ===" << std::endl;
+
+    try {
+        size_t threadCount = std::thread::hardware_concurrency();
+        threadCount = threadCount == 0 ? 1 : threadCount;
+        size_t poolThreads = std::min(threadCount, (size_t)4);
+
+        std::cout << "Creating a thread pool with " << poolThreads << " threads" << std::endl;
+        ThreadPool pool(poolThreads);
+
+        std::cout << "\n--- Testing Nested Submissions ---" << std::endl;
+        const int depth = 12;
+        std::atomic<int> leaves{0};
+        pool.enqueue(spawnTree, std::ref(pool), depth, std::ref(leaves));
+        pool.waitForCompletion();
+
+        std::cout << "Leaves reached: " << leaves << " (expected " << (1 << depth) << ")" << std::endl;
+        if (leaves != (1 << depth)) {
+            throw std::runtime_error("Nested submission verification failed!");
+        }
+
+        std::cout << "\n--- Testing Pause/Resume With Local Tasks ---" << std::endl;
+        leaves = 0;
+        pool.enqueue([&pool, &leaves] {
+            pool.pause();
+            for (int i = 0; i < 8; ++i) {
+                pool.enqueue([&leaves] { ++leaves; });
+            }
+        }).get();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::cout << "Pending tasks while paused: " << pool.getTaskCount() << std::endl;
+        if (leaves != 0 || pool.getTaskCount() != 8) {
+            throw std::runtime_error("Paused pool executed local tasks!");
+        }
+
+        // Shrinking hands the retired workers' local tasks back to the remaining ones
+        pool.resize(1);
+        pool.resume();
+        pool.waitForCompletion();
+        std::cout << "Tasks run after resume: " << leaves << std::endl;
+        if (leaves != 8) {
+            throw std::runtime_error("Local tasks lost across pause/resize!");
+        }
+
+        std::cout << "\n--- Testing Resize With Nested Submissions ---" << std::endl;
+        pool.resize(poolThreads + 2);
+        leaves = 0;
+        pool.enqueue(spawnTree, std::ref(pool), depth, std::ref(leaves));
+        pool.waitForCompletion();
+        std::cout << "Leaves reached: " << leaves << std::endl;
+        if (leaves != (1 << depth)) {
+            throw std::runtime_error("Nested submission after resize failed!");
+        }
+
+        std::cout << "Completed tasks: " << pool.getCompletedTaskCount() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 6 Test Completed ===" << std::endl;
+    return 0;
+}
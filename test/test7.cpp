@@ -0,0 +1,92 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include "ThreadPool.h"
+
+// Count every global heap allocation made by the process
+static std::atomic<size_t> heapAllocations{0};
+
+void* operator new(size_t size) {
+    ++heapAllocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Submit a round of small lambdas and collect their results
+long long runRound(ThreadPool& pool, std::vector<std::future<int>>& results, int count) {
+    results.clear();
+    for (int i = 0; i < count; ++i) {
+        results.push_back(pool.enqueue([i] { return i * 2; }));
+    }
+    long long sum = 0;
+    for (auto& result : results) {
+        sum += result.get();
+    }
+    return sum;
+}
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 7 Test (Allocation-Free Tasks) ===" << std::endl;
+
+    try {
+        std::cout << "\n--- Checking Inline Task Storage ---" << std::endl;
+        auto small = [x = 1, y = 2] { return x + y; };
+        auto large = [s = std::string(), t = std::string()] { return s + t; };
+        std::cout << "sizeof(TaskFunction): " << sizeof(TaskFunction) << " bytes" << std::endl;
+        std::cout << "Small lambda stored inline: " << (TaskFunction::fitsInline<decltype(small)>() ? "Yes" : "No") << std::endl;
+        std::cout << "Two-string lambda stored inline: " << (TaskFunction::fitsInline<decltype(large)>() ? "Yes" : "No") << std::endl;
+        if (!TaskFunction::fitsInline<decltype(small)>()) {
+            throw std::runtime_error("Small lambda does not fit the inline buffer!");
+        }
+
+        ThreadPool pool(2);
+        const int count = 1000;
+        std::vector<std::future<int>> results;
+        results.reserve(count);
+
+        // Warm up: grows the injection queue and fills the slab free lists
+        // Paused first so the injection ring grows to a full round here; a measured
+        // round that queues deeper than the warm-up did would grow it again
+        std::cout << "\n--- Warming Up ---" << std::endl;
+        pool.pause();
+        for (int i = 0; i < count; ++i) {
+            results.push_back(pool.enqueue([i] { return i * 2; }));
+        }
+        pool.resume();
+        runRound(pool, results, count);
+        pool.waitForCompletion();
+
+        std::cout << "\n--- Counting Allocations In Steady State ---" << std::endl;
+        size_t before = heapAllocations;
+        long long sum = runRound(pool, results, count);
+        size_t allocations = heapAllocations - before;
+
+        std::cout << "Sum of results: " << sum << std::endl;
+        std::cout << "Heap allocations for " << count << " submissions: " << allocations << std::endl;
+        if (sum != static_cast<long long>(count) * (count - 1)) {
+            throw std::runtime_error("Wrong task results!");
+        }
+        if (allocations != 0) {
+            throw std::runtime_error("Small task submission allocated on the heap!");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 7 Test Completed ===" << std::endl;
+    return 0;
+}
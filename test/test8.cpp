@@ -0,0 +1,74 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "ThreadPool.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 8 Test (Fire-and-Forget) ===" << std::endl;
+
+    try {
+        ThreadPool pool(4);
+
+        std::cout << "\n--- Posting Tasks Without Futures ---" << std::endl;
+        std::atomic<int> executed{0};
+        const int count = 10000;
+        for (int i = 0; i < count; ++i) {
+            pool.post([&executed] { ++executed; });
+        }
+        pool.waitForCompletion();
+        std::cout << "Executed posted tasks: " << executed << std::endl;
+        if (executed != count) {
+            throw std::runtime_error("Posted tasks were lost!");
+        }
+
+        std::cout << "\n--- Routing Exceptions To The Error Handler ---" << std::endl;
+        std::atomic<int> handled{0};
+        pool.setErrorHandler([&handled](std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::runtime_error&) {
+                ++handled;
+            }
+        });
+
+        for (int i = 0; i < 10; ++i) {
+            pool.post([i] {
+                if (i % 2 == 0) {
+                    throw std::runtime_error("Posted task " + std::to_string(i) + " failed");
+                }
+            });
+        }
+        pool.waitForCompletion();
+
+        std::cout << "Handled exceptions: " << handled << std::endl;
+        std::cout << "Failed task count: " << pool.getFailedTaskCount() << std::endl;
+        if (handled != 5 || pool.getFailedTaskCount() != 5) {
+            throw std::runtime_error("Exceptions were not routed to the error handler!");
+        }
+
+        std::cout << "\n--- Comparing post() With enqueue() ---" << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            pool.enqueue([&executed] { ++executed; });
+        }
+        pool.waitForCompletion();
+        auto enqueueTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            pool.post([&executed] { ++executed; });
+        }
+        pool.waitForCompletion();
+        auto postTime = std::chrono::steady_clock::now() - start;
+
+        std::cout << "enqueue(): " << std::chrono::duration_cast<std::chrono::microseconds>(enqueueTime).count() << " us for " << count << " tasks" << std::endl;
+        std::cout << "post():    " << std::chrono::duration_cast<std::chrono::microseconds>(postTime).count() << " us for " << count << " tasks" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 8 Test Completed ===" << std::endl;
+    return 0;
+}
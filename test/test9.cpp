@@ -0,0 +1,79 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "ThreadPool.h"
+
+int main() {
+    std::cout << "=== C++11 ThreadPool Implementation - Day 9 Test (Bulk Submission) ===" << std::endl;
+
+    try {
+        ThreadPool pool(4);
+
+        std::cout << "\n--- Testing enqueueBulk() ---" << std::endl;
+        std::vector<std::function<int()>> jobs;
+        for (int i = 0; i < 500; ++i) {
+            jobs.push_back([i] { return i * i; });
+        }
+
+        auto results = pool.enqueueBulk(jobs.begin(), jobs.end());
+        long long sum = 0;
+        for (auto& result : results) {
+            sum += result.get();
+        }
+        std::cout << "Futures returned: " << results.size() << ", sum of squares: " << sum << std::endl;
+        if (results.size() != jobs.size() || sum != 41541750) {
+            throw std::runtime_error("enqueueBulk verification failed!");
+        }
+
+        std::cout << "\n--- Testing submitBatch() ---" << std::endl;
+        std::atomic<int> executed{0};
+        std::vector<std::function<void()>> batch;
+        for (int i = 0; i < 200; ++i) {
+            batch.push_back([&executed] { ++executed; });
+        }
+        pool.submitBatch(std::move(batch)).get();
+        std::cout << "Batch tasks executed: " << executed << std::endl;
+        if (executed != 200) {
+            throw std::runtime_error("submitBatch completed before all tasks ran!");
+        }
+
+        std::cout << "\n--- Testing submitBatch() Error Propagation ---" << std::endl;
+        std::vector<std::function<void()>> failing;
+        for (int i = 0; i < 50; ++i) {
+            failing.push_back([i] {
+                if (i == 25) {
+                    throw std::runtime_error("Batch task 25 failed");
+                }
+            });
+        }
+        try {
+            pool.submitBatch(std::move(failing)).get();
+            throw std::logic_error("submitBatch swallowed the exception!");
+        } catch (const std::runtime_error& e) {
+            std::cout << "Batch failed as expected: " << e.what() << std::endl;
+        }
+
+        std::cout << "\n--- Testing Bulk Submission From A Worker ---" << std::endl;
+        executed = 0;
+        pool.enqueue([&pool, &executed] {
+            std::vector<std::function<void()>> nested(100, [&executed] { ++executed; });
+            pool.enqueueBulk(nested.begin(), nested.end());
+        }).get();
+        pool.waitForCompletion();
+        std::cout << "Nested batch tasks executed: " << executed << std::endl;
+        if (executed != 100) {
+            throw std::runtime_error("Nested bulk submission lost tasks!");
+        }
+
+        std::cout << "Empty batch is ready immediately: "
+                  << (pool.submitBatch(std::vector<std::function<void()>>{}).wait_for(std::chrono::seconds(0)) == std::future_status::ready ? "Yes" : "No")
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n=== Day 9 Test Completed ===" << std::endl;
+    return 0;
+}